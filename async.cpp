@@ -0,0 +1,158 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+#include "async.hpp"
+
+using namespace templet;
+using namespace templet::types;
+
+DataFuture::DataFuture(DataType type, std::shared_future<DataPtr> future)
+    : _type(type), _future(std::move(future)) {
+
+}
+
+const Data& DataFuture::get() const {
+    const auto& data = _future.get();
+    if(!data || data->type() != _type) {
+        throw std::runtime_error("Data future returned a wrong type");
+    }
+    return *data;
+}
+
+bool DataFuture::empty() const {
+    return get().empty();
+}
+
+std::string DataFuture::getValue() const {
+    return get().getValue();
+}
+
+const DataVector& DataFuture::getList() const {
+    return get().getList();
+}
+
+const DataMap& DataFuture::getMap() const {
+    return get().getMap();
+}
+
+const Data* DataFuture::getItem(std::size_t index, DataPtr& holder) const {
+    return get().getItem(index, holder);
+}
+
+const Data* DataFuture::getItem(const std::string& key, DataPtr& holder) const {
+    return get().getItem(key, holder);
+}
+
+std::unique_ptr<DataCursor> DataFuture::getCursor() const {
+    return get().getCursor();
+}
+
+void DataFuture::write(std::ostream& os) const {
+    get().write(os);
+}
+
+bool DataFuture::ready() const {
+    if(_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return false;
+    }
+    return get().ready();
+}
+
+void DataFuture::wait() const {
+    _future.wait();
+    try {
+        get().wait();
+    }
+    catch(...) {
+        // Errors are reported when the value is read
+    }
+}
+
+DataType DataFuture::type() const {
+    return _type;
+}
+
+DataPtr templet::make_future(DataType type, std::shared_future<DataPtr> future) {
+    return std::make_shared<DataFuture>(type, std::move(future));
+}
+
+RenderTask::RenderTask(ChunkRenderer chunks, std::ostream& os)
+    : _chunks(std::move(chunks)), _os(os), _promise(), _chunk() {
+
+}
+
+std::future<void> RenderTask::future() {
+    return _promise.get_future();
+}
+
+bool RenderTask::resume() {
+    try {
+        while(_chunks.tryNext(_chunk)) {
+            _os.write(_chunk.data(), static_cast<std::streamsize>(_chunk.size()));
+            if(_chunks.pending()) {
+                return false;
+            }
+        }
+        _promise.set_value();
+    }
+    catch(...) {
+        _promise.set_exception(std::current_exception());
+    }
+    return true;
+}
+
+void RenderTask::wait() const {
+    if(const auto value = _chunks.pending()) {
+        value->wait();
+    }
+}
+
+void LocalExecutor::post(std::unique_ptr<RenderTask> task) {
+    _tasks.push_back(std::move(task));
+}
+
+void LocalExecutor::run() {
+    // Tasks that were suspended since one made progress
+    std::size_t suspended = 0;
+    while(!_tasks.empty()) {
+        auto task = std::move(_tasks.front());
+        _tasks.pop_front();
+        if(task->resume()) {
+            suspended = 0;
+            continue;
+        }
+        if(++suspended > _tasks.size()) {
+            // Every task is waiting, block instead of spinning
+            task->wait();
+            suspended = 0;
+        }
+        _tasks.push_back(std::move(task));
+    }
+}
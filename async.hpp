@@ -0,0 +1,178 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef ASYNC_HPP
+#define ASYNC_HPP
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <ostream>
+#include <string>
+#include "chunks.hpp"
+#include "types.hpp"
+
+namespace templet {
+namespace types {
+
+/**
+ * @brief The DataFuture class wraps a value that is computed elsewhere
+ *
+ * E.g. on another thread. The value is not ready until the future is,
+ * and reading it before that waits for it.
+ */
+class DataFuture : public Data {
+private:
+    DataType _type;
+    std::shared_future<DataPtr> _future;
+
+    /**
+     * @brief Wait for the future
+     * @exception std::runtime_error if the future returns a wrong type
+     * @return Computed data
+     */
+    const Data& get() const;
+
+public:
+    /**
+     * @brief Construct a DataFuture with a type and a future
+     * @param type Type of the data that the future returns
+     * @param future Future that returns the data
+     */
+    DataFuture(DataType type, std::shared_future<DataPtr> future);
+
+    bool empty() const override;
+    std::string getValue() const override;
+    const DataVector& getList() const override;
+    const DataMap& getMap() const override;
+    const Data* getItem(std::size_t index, DataPtr& holder) const override;
+    const Data* getItem(const std::string& key, DataPtr& holder) const override;
+    std::unique_ptr<DataCursor> getCursor() const override;
+    void write(std::ostream& os) const override;
+    bool ready() const override;
+    void wait() const override;
+    DataType type() const override;
+};
+
+} // namespace types
+
+/**
+ * @brief Wrap a future in a DataPtr
+ * @param type Type of the data that the future returns
+ * @param future Future that returns the data
+ * @return Future wrapped in DataPtr
+ */
+types::DataPtr make_future(types::DataType type, std::shared_future<types::DataPtr> future);
+
+/**
+ * @brief The RenderTask class is a render that can be suspended
+ *
+ * Each call to \link resume \endlink renders until the output is complete
+ * or until a tag reads a value that isn't ready.
+ */
+class RenderTask {
+private:
+    ChunkRenderer _chunks;
+    std::ostream& _os;
+    std::promise<void> _promise;
+    std::string _chunk;
+
+public:
+    /**
+     * @brief Construct a RenderTask
+     * @param chunks Renderer of the template
+     * @param os Output stream, must outlive the task
+     */
+    RenderTask(ChunkRenderer chunks, std::ostream& os);
+
+    /**
+     * @brief Get the future that is set when the render is complete
+     *
+     * Errors are stored in the future. Can only be called once.
+     *
+     * @return Future of the render
+     */
+    std::future<void> future();
+
+    /**
+     * @brief Render until the output is complete or a value isn't ready
+     * @return True if the render is complete, otherwise false
+     */
+    bool resume();
+
+    /**
+     * @brief Wait until the value that suspended the render is ready
+     */
+    void wait() const;
+};
+
+/**
+ * @brief The Executor class runs render tasks
+ */
+class Executor {
+public:
+    virtual ~Executor() = default;
+
+    /**
+     * @brief Schedule a task
+     *
+     * The executor calls \link RenderTask::resume \endlink until it returns true
+     *
+     * @param task Task to run
+     */
+    virtual void post(std::unique_ptr<RenderTask> task) = 0;
+};
+
+/**
+ * @brief The LocalExecutor class runs render tasks on the calling thread
+ *
+ * Tasks are resumed in turns, so a task waiting for a value doesn't
+ * hold up the others. When every task is waiting, \link run \endlink
+ * blocks on one of them.
+ *
+ * Example usage:
+ *
+ * templet::LocalExecutor executor;\n
+ * auto page = tpl.renderAsync(values, os, executor);\n
+ * executor.run();\n
+ * page.get();
+ */
+class LocalExecutor : public Executor {
+private:
+    std::deque<std::unique_ptr<RenderTask>> _tasks;
+
+public:
+    void post(std::unique_ptr<RenderTask> task) override;
+
+    /**
+     * @brief Run the tasks until they're complete
+     */
+    void run();
+};
+
+} // namespace templet
+
+#endif // ASYNC_HPP
@@ -0,0 +1,136 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include <algorithm>
+#include <iostream>
+#include "batch.hpp"
+#include "templet.hpp"
+
+using namespace templet::helpers;
+
+BatchWriter::BatchWriter(std::size_t threads, std::size_t maxQueued)
+    : _mutex(),
+      _queued(),
+      _done(),
+      _queue(),
+      _threads(),
+      _maxQueued(std::max<std::size_t>(maxQueued, 1)),
+      _active(0),
+      _stopping(false),
+      _error()
+{
+    if(threads == 0) {
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    _threads.reserve(threads);
+    for(std::size_t i = 0; i < threads; ++i) {
+        _threads.emplace_back(&BatchWriter::work, this);
+    }
+}
+
+BatchWriter::~BatchWriter() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _queued.notify_all();
+    for(auto& thread : _threads) {
+        thread.join();
+    }
+    if(_error) {
+        try {
+            std::rethrow_exception(_error);
+        }
+        catch(const std::exception& ex) {
+            std::cerr << "BatchWriter: " << ex.what() << "\n";
+        }
+        catch(...) {
+            std::cerr << "BatchWriter: a file couldn't be written\n";
+        }
+    }
+}
+
+void BatchWriter::work() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    for(;;) {
+        _queued.wait(lock, [this]{
+            return _stopping || !_queue.empty();
+        });
+        if(_queue.empty()) {
+            // Stopping and nothing left to write
+            return;
+        }
+        auto file = std::move(_queue.front());
+        _queue.pop_front();
+        ++_active;
+        // A slot is free for a waiting writer
+        _done.notify_all();
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            FileWriter::toFile(file.first, file.second);
+        }
+        catch(...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+        --_active;
+        if(error && !_error) {
+            _error = error;
+        }
+        _done.notify_all();
+    }
+}
+
+void BatchWriter::write(std::string path, std::string text) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]{
+        return _queue.size() < _maxQueued;
+    });
+    _queue.emplace_back(std::move(path), std::move(text));
+    lock.unlock();
+    _queued.notify_one();
+}
+
+void BatchWriter::finish() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]{
+        return _queue.empty() && _active == 0;
+    });
+    if(_error) {
+        std::exception_ptr error;
+        std::swap(error, _error);
+        std::rethrow_exception(error);
+    }
+}
+
+BatchWriter& BatchWriter::shared() {
+    static BatchWriter writer;
+    return writer;
+}
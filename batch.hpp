@@ -0,0 +1,141 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef BATCH_HPP
+#define BATCH_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace templet {
+namespace helpers {
+
+/**
+ * @brief The BatchWriter class writes files on a pool of threads
+ *
+ * write() queues the contents of a file and returns, so the caller
+ * can render the next file while earlier ones are opened, written and
+ * closed. When the queue is full, write() waits for a free slot, which
+ * bounds the memory held by pending files.
+ *
+ * Example usage:
+ *
+ * templet::helpers::BatchWriter writer;\n
+ * for(const auto& page : pages) {\n
+ *     writer.write(page.path, tpl.parse(page.values));\n
+ * }\n
+ * writer.finish();
+ *
+ * Errors are reported by \link finish \endlink. The destructor waits for
+ * pending writes and prints an error that finish() didn't report to
+ * std::cerr, as it can't throw.
+ */
+class BatchWriter {
+private:
+    std::mutex _mutex;
+    std::condition_variable _queued;
+    std::condition_variable _done;
+    std::deque<std::pair<std::string, std::string>> _queue;
+    std::vector<std::thread> _threads;
+    std::size_t _maxQueued;
+    std::size_t _active;
+    bool _stopping;
+    std::exception_ptr _error;
+
+    void work();
+
+public:
+    /**
+     * @brief Construct a BatchWriter and start its threads
+     * @param threads Number of threads, 0 for the number of hardware threads
+     * @param maxQueued Number of files that may wait to be written
+     */
+    explicit BatchWriter(std::size_t threads = 0, std::size_t maxQueued = 1024);
+
+    BatchWriter(const BatchWriter&) = delete;
+    BatchWriter& operator=(const BatchWriter&) = delete;
+
+    ~BatchWriter();
+
+    /**
+     * @brief Queue a file to be written
+     *
+     * Note: Overwrites existing content
+     *
+     * @param path Path to file
+     * @param text String to write
+     */
+    void write(std::string path, std::string text);
+
+    /**
+     * @brief Wait until all queued files are written
+     * @exception std::runtime_error the first error since the last call, if a file couldn't be written
+     */
+    void finish();
+
+    /**
+     * @brief Get the writer that \link BatchFileWriter \endlink uses
+     * @return Writer shared by the process
+     */
+    static BatchWriter& shared();
+};
+
+/**
+ * @brief Queues string contents to be written to a given file
+ *
+ * A FileWriterT policy for \link templet::Templet::save \endlink that
+ * writes through \link BatchWriter::shared \endlink. Call
+ * BatchWriter::shared().finish() after the last save.
+ *
+ * Example usage:
+ *
+ * tpl.save<templet::helpers::BatchFileWriter>("out/index.html");
+ */
+struct BatchFileWriter {
+    /**
+     * @brief Queue string contents to be written to a file
+     *
+     * Note: Overwrites existing content
+     *
+     * @param path Path to file
+     * @param text String to write
+     */
+    static void toFile(std::string path, std::string text) {
+        BatchWriter::shared().write(std::move(path), std::move(text));
+    }
+};
+
+} // namespace helpers
+} // namespace templet
+
+#endif // BATCH_HPP
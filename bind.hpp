@@ -0,0 +1,525 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef BIND_HPP
+#define BIND_HPP
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "ptrutil.hpp"
+#include "segments.hpp"
+#include "types.hpp"
+
+namespace templet {
+
+/**
+ * @brief The Binding trait registers the fields of a struct for rendering
+ *
+ * Specialise it with a static fields function that names the members,
+ * or getters that return a const reference. Fields can be strings,
+ * bools, integers, floating point numbers, bound structs and vectors
+ * of these. A bool that is false is treated as not set.
+ *
+ * Example usage:
+ *
+ * struct Server { std::string name; int id; std::vector<std::string> tags; };\n
+ * \n
+ * namespace templet {\n
+ * template <> struct Binding<Server> {\n
+ *     static void fields(binding::Fields<Server>& f) {\n
+ *         f("name", &Server::name)("id", &Server::id)("tags", &Server::tags);\n
+ *     }\n
+ * };\n
+ * }\n
+ * \n
+ * data["servers"] = templet::make_binding(servers); // const std::vector<Server>&
+ */
+template <class T>
+struct Binding;
+
+namespace binding {
+
+/**
+ * @brief The FieldBase class reads a field of a bound struct
+ */
+template <class T>
+class FieldBase {
+public:
+    virtual ~FieldBase() = default;
+
+    /**
+     * @brief Create a view of the field of an object
+     * @param object Object to read
+     * @param holder Receives the view, which belongs to the caller
+     * @return View of the field, or nullptr if the field is not set
+     */
+    virtual const types::Data* get(const T& object, types::DataPtr& holder) const = 0;
+};
+
+/**
+ * @brief The Fields class holds the registered fields of a struct
+ *
+ * The fields are registered once per type, see \link fields_of \endlink,
+ * and never change after that, so renders in different threads can
+ * read them.
+ */
+template <class T>
+class Fields {
+private:
+    std::vector<std::pair<std::string, std::unique_ptr<FieldBase<T>>>> _fields;
+    // Index of each name in _fields, a name registered twice keeps the first
+    std::map<std::string, std::size_t> _index;
+
+    void add(std::string name, std::unique_ptr<FieldBase<T>> field) {
+        _index.emplace(name, _fields.size());
+        _fields.emplace_back(std::move(name), std::move(field));
+    }
+
+public:
+    /**
+     * @brief Register a data member
+     * @param name Name used in templates
+     * @param member Pointer to member
+     * @return This object for chaining
+     */
+    template <class F, class = typename std::enable_if<!std::is_function<F>::value>::type>
+    Fields& operator()(std::string name, F T::* member);
+
+    /**
+     * @brief Register a getter
+     * @param name Name used in templates
+     * @param getter Pointer to a const member function that returns a const reference
+     * @return This object for chaining
+     */
+    template <class F>
+    Fields& operator()(std::string name, const F& (T::*getter)() const);
+
+    /**
+     * @brief Get the registered fields
+     * @return Names and fields in registration order
+     */
+    const std::vector<std::pair<std::string, std::unique_ptr<FieldBase<T>>>>& list() const {
+        return _fields;
+    }
+
+    /**
+     * @brief Find a field by name
+     * @param name Name used in templates
+     * @return Field, or nullptr if no field has the name
+     */
+    const FieldBase<T>* find(const std::string& name) const {
+        const auto it = _index.find(name);
+        return it == _index.cend() ? nullptr : _fields[it->second].second.get();
+    }
+};
+
+/**
+ * @brief Get the fields registered by Binding<T>, once per type
+ * @return Registered fields
+ */
+template <class T>
+const Fields<T>& fields_of() {
+    static const Fields<T> fields = []{
+        Fields<T> result;
+        Binding<T>::fields(result);
+        return result;
+    }();
+    return fields;
+}
+
+/**
+ * @brief The StringView class refers to a std::string
+ */
+class StringView final : public types::Data {
+private:
+    const std::string* _value;
+
+public:
+    explicit StringView(const std::string* value) : _value(value) {}
+
+    bool empty() const override {
+        return _value->empty();
+    }
+
+    std::string getValue() const override {
+        return *_value;
+    }
+
+    void write(std::ostream& os) const override {
+        write_stable(os, _value->data(), _value->size());
+    }
+
+    types::DataType type() const override {
+        return types::DataType::String;
+    }
+};
+
+/**
+ * @brief The BoolView class refers to a bool, which is written as "true" or nothing
+ */
+class BoolView final : public types::Data {
+private:
+    const bool* _value;
+
+public:
+    explicit BoolView(const bool* value) : _value(value) {}
+
+    bool empty() const override {
+        return !*_value;
+    }
+
+    std::string getValue() const override {
+        return *_value ? "true" : "";
+    }
+
+    types::DataType type() const override {
+        return types::DataType::String;
+    }
+};
+
+/**
+ * @brief The IntegerView class refers to an integer
+ */
+template <class F>
+class IntegerView final : public types::Data {
+private:
+    const F* _value;
+
+    bool fitsLongLong() const {
+        return !std::is_unsigned<F>::value ||
+                static_cast<unsigned long long>(*_value) <= static_cast<unsigned long long>(std::numeric_limits<long long>::max());
+    }
+
+public:
+    explicit IntegerView(const F* value) : _value(value) {}
+
+    bool empty() const override {
+        return false;
+    }
+
+    std::string getValue() const override {
+        return std::to_string(*_value);
+    }
+
+    void write(std::ostream& os) const override {
+        if(fitsLongLong()) {
+            types::DataInteger(static_cast<long long>(*_value)).write(os);
+        }
+        else {
+            os << *_value;
+        }
+    }
+
+    types::DataType type() const override {
+        return fitsLongLong() ? types::DataType::Integer : types::DataType::String;
+    }
+};
+
+/**
+ * @brief The FloatView class refers to a floating point number
+ */
+template <class F>
+class FloatView final : public types::Data {
+private:
+    const F* _value;
+
+public:
+    explicit FloatView(const F* value) : _value(value) {}
+
+    bool empty() const override {
+        return false;
+    }
+
+    std::string getValue() const override {
+        return types::DataFloat(static_cast<double>(*_value)).getValue();
+    }
+
+    void write(std::ostream& os) const override {
+        types::DataFloat(static_cast<double>(*_value)).write(os);
+    }
+
+    types::DataType type() const override {
+        return types::DataType::Float;
+    }
+};
+
+template <class T>
+class StructView;
+
+template <class E>
+class ListView;
+
+/**
+ * @brief The ViewOf trait selects the view class of a field type
+ */
+template <class F, class Enable = void>
+struct ViewOf {
+    using type = StructView<F>;
+};
+
+template <>
+struct ViewOf<std::string> {
+    using type = StringView;
+};
+
+template <>
+struct ViewOf<bool> {
+    using type = BoolView;
+};
+
+template <class F>
+struct ViewOf<F, typename std::enable_if<std::is_integral<F>::value && !std::is_same<F, bool>::value>::type> {
+    using type = IntegerView<F>;
+};
+
+template <class F>
+struct ViewOf<F, typename std::enable_if<std::is_floating_point<F>::value>::type> {
+    using type = FloatView<F>;
+};
+
+template <class E>
+struct ViewOf<std::vector<E>> {
+    using type = ListView<E>;
+};
+
+inline bool is_set(const bool& value) {
+    return value;
+}
+
+template <class F>
+bool is_set(const F& /*value*/) {
+    return true;
+}
+
+/**
+ * @brief The Field class reads a field through an accessor
+ *
+ * A field has no state besides the accessor, every lookup gets its
+ * own view of the field.
+ */
+template <class T, class F, class Accessor>
+class Field final : public FieldBase<T> {
+private:
+    using View = typename ViewOf<F>::type;
+
+    Accessor _accessor;
+
+public:
+    explicit Field(Accessor accessor) : _accessor(accessor) {}
+
+    const types::Data* get(const T& object, types::DataPtr& holder) const override {
+        const F& value = _accessor(object);
+        if(!is_set(value)) {
+            return nullptr;
+        }
+        holder = std::make_shared<View>(&value);
+        return holder.get();
+    }
+};
+
+template <class T, class F>
+struct MemberAccessor {
+    F T::* member;
+
+    const F& operator()(const T& object) const {
+        return object.*member;
+    }
+};
+
+template <class T, class F>
+struct GetterAccessor {
+    const F& (T::*getter)() const;
+
+    const F& operator()(const T& object) const {
+        return (object.*getter)();
+    }
+};
+
+template <class T>
+template <class F, class>
+Fields<T>& Fields<T>::operator()(std::string name, F T::* member) {
+    const MemberAccessor<T, F> accessor {member};
+    add(std::move(name), mylib::make_unique<Field<T, F, MemberAccessor<T, F>>>(accessor));
+    return *this;
+}
+
+template <class T>
+template <class F>
+Fields<T>& Fields<T>::operator()(std::string name, const F& (T::*getter)() const) {
+    const GetterAccessor<T, F> accessor {getter};
+    add(std::move(name), mylib::make_unique<Field<T, F, GetterAccessor<T, F>>>(accessor));
+    return *this;
+}
+
+/**
+ * @brief The StructView class is a map of the fields of a bound struct
+ *
+ * A lookup finds the field in the name table of the type and creates
+ * a view of it for the caller. getMap builds its map on the first call,
+ * guarded by std::call_once, so a view never changes after it's created
+ * and renders in different threads can share it. The map holds the
+ * fields that were set at that time, their values are read on access.
+ */
+template <class T>
+class StructView final : public types::Data {
+private:
+    const T* _object;
+    mutable std::once_flag _mapOnce;
+    mutable types::DataMap _map;
+
+public:
+    explicit StructView(const T* object) : _object(object), _mapOnce(), _map() {}
+
+    bool empty() const override {
+        return fields_of<T>().list().empty();
+    }
+
+    const types::DataMap& getMap() const override {
+        std::call_once(_mapOnce, [this]{
+            for(const auto& field : fields_of<T>().list()) {
+                types::DataPtr view;
+                if(field.second->get(*_object, view)) {
+                    _map.emplace(field.first, std::move(view));
+                }
+            }
+        });
+        return _map;
+    }
+
+    const types::Data* getItem(const std::string& key, types::DataPtr& holder) const override {
+        const auto field = fields_of<T>().find(key);
+        return field ? field->get(*_object, holder) : nullptr;
+    }
+
+    types::DataType type() const override {
+        return types::DataType::Mapper;
+    }
+};
+
+/**
+ * @brief The ListCursor class reads the elements of a bound vector
+ *
+ * The view of each element is created in place of the previous one,
+ * so the cursor doesn't allocate
+ */
+template <class E>
+class ListCursor final : public types::DataCursor {
+private:
+    const std::vector<E>& _data;
+    std::size_t _pos;
+    mylib::InPlace<typename ViewOf<E>::type> _item;
+
+public:
+    explicit ListCursor(const std::vector<E>& data) : _data(data), _pos(0), _item() {}
+
+    const types::Data* next() override {
+        if(_pos == _data.size()) {
+            return nullptr;
+        }
+        return &_item.emplace(&_data[_pos++]);
+    }
+};
+
+/**
+ * @brief The ListView class refers to a vector of bindable elements
+ *
+ * getList builds its list on the first call, guarded by std::call_once
+ */
+template <class E>
+class ListView final : public types::Data {
+private:
+    using View = typename ViewOf<E>::type;
+
+    const std::vector<E>* _value;
+    mutable std::once_flag _listOnce;
+    mutable types::DataVector _list;
+
+public:
+    explicit ListView(const std::vector<E>* value) : _value(value), _listOnce(), _list() {}
+
+    bool empty() const override {
+        return _value->empty();
+    }
+
+    /**
+     * @brief Creates a view of every element once, the parser uses \link getCursor \endlink
+     */
+    const types::DataVector& getList() const override {
+        std::call_once(_listOnce, [this]{
+            _list.reserve(_value->size());
+            for(const auto& element : *_value) {
+                _list.push_back(std::make_shared<View>(&element));
+            }
+        });
+        return _list;
+    }
+
+    const types::Data* getItem(std::size_t index, types::DataPtr& holder) const override {
+        if(index >= _value->size()) {
+            return nullptr;
+        }
+        holder = std::make_shared<View>(&(*_value)[index]);
+        return holder.get();
+    }
+
+    std::unique_ptr<types::DataCursor> getCursor() const override {
+        return mylib::make_unique<ListCursor<E>>(*_value);
+    }
+
+    types::DataType type() const override {
+        return types::DataType::List;
+    }
+};
+
+} // namespace binding
+
+/**
+ * @brief Bind an object to a DataPtr without copying it
+ *
+ * The object can be a struct registered with \link Binding \endlink,
+ * a vector of them, or any other field type. The object must outlive
+ * the renders that use the returned value, and its vectors must not
+ * change size while a list of them returned by getList is used.
+ *
+ * @param object Object to bind
+ * @return View of the object wrapped in DataPtr
+ */
+template <class T>
+static inline types::DataPtr make_binding(const T& object) {
+    return std::make_shared<typename binding::ViewOf<T>::type>(&object);
+}
+
+} // namespace templet
+
+#endif // BIND_HPP
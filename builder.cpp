@@ -0,0 +1,95 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include "builder.hpp"
+
+using namespace templet;
+using namespace templet::types;
+
+Arena::Arena(std::size_t blockSize)
+    : _blocks(), _blockSize(blockSize), _pos(nullptr), _left(0), _reserved(0) {
+
+}
+
+void* Arena::allocate(std::size_t size, std::size_t alignment) {
+    auto padding = (alignment - reinterpret_cast<std::uintptr_t>(_pos) % alignment) % alignment;
+    if(_pos == nullptr || padding + size > _left) {
+        // Reserve enough for large allocations that don't fit in a block
+        const auto blockSize = std::max(_blockSize, size + alignment);
+        _blocks.emplace_back(new char[blockSize]);
+        _pos = _blocks.back().get();
+        _left = blockSize;
+        _reserved += blockSize;
+        padding = (alignment - reinterpret_cast<std::uintptr_t>(_pos) % alignment) % alignment;
+    }
+
+    void* p = _pos + padding;
+    _pos += padding + size;
+    _left -= padding + size;
+    return p;
+}
+
+std::size_t Arena::reserved() const {
+    return _reserved;
+}
+
+DataBuilder::DataBuilder(std::size_t blockSize)
+    : _arena(std::make_shared<Arena>(blockSize)) {
+
+}
+
+const Arena& DataBuilder::arena() const {
+    return *_arena;
+}
+
+DataPtr DataBuilder::make(std::string value) {
+    return create<DataValue>(std::move(value));
+}
+
+DataPtr DataBuilder::make(DataVector value) {
+    return create<DataList>(std::move(value));
+}
+
+DataPtr DataBuilder::make(std::vector<std::string> value) {
+    DataVector list;
+    list.reserve(value.size());
+    for(auto& item : value) {
+        list.push_back(make(std::move(item)));
+    }
+    return make(std::move(list));
+}
+
+DataPtr DataBuilder::makeStringList(std::vector<std::string> value) {
+    return create<DataStringList>(std::move(value));
+}
+
+DataPtr DataBuilder::make(DataMap value) {
+    return create<DataMapper>(std::move(value));
+}
@@ -0,0 +1,229 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef BUILDER_HPP
+#define BUILDER_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "types.hpp"
+
+namespace templet {
+namespace types {
+
+/**
+ * @brief The Arena class hands out memory from large blocks
+ *
+ * Memory is never returned to the arena, all blocks are freed
+ * together when the arena is destroyed. Not thread-safe.
+ */
+class Arena {
+private:
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    std::size_t _blockSize;
+    char* _pos;
+    std::size_t _left;
+    std::size_t _reserved;
+
+public:
+    /**
+     * @brief Construct an Arena
+     * @param blockSize Size of the blocks to reserve
+     */
+    explicit Arena(std::size_t blockSize);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * @brief Allocate memory
+     * @param size Number of bytes
+     * @param alignment Alignment of the memory
+     * @exception std::bad_alloc if a new block can't be reserved
+     * @return Pointer to the allocated memory
+     */
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    /**
+     * @brief Get the number of bytes reserved for blocks
+     * @return Reserved bytes
+     */
+    std::size_t reserved() const;
+};
+
+/**
+ * @brief The ArenaAllocator class is a standard allocator that allocates from an Arena
+ *
+ * Each copy of the allocator keeps the arena alive
+ */
+template <class T>
+class ArenaAllocator {
+private:
+    std::shared_ptr<Arena> _arena;
+
+public:
+    using value_type = T;
+
+    ArenaAllocator(std::shared_ptr<Arena> arena) : _arena(std::move(arena)) {}
+
+    template <class U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : _arena(other.arena()) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* /*p*/, std::size_t /*n*/) {
+        // Freed with the arena
+    }
+
+    const std::shared_ptr<Arena>& arena() const {
+        return _arena;
+    }
+};
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+    return lhs.arena() == rhs.arena();
+}
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) {
+    return !(lhs == rhs);
+}
+
+} // namespace types
+
+/**
+ * @brief The DataBuilder class creates data objects in an arena
+ *
+ * The data objects and their reference counts are allocated from
+ * blocks that are freed in one go when the builder and all the data
+ * it created are gone. Strings, vectors and maps inside the data
+ * objects still use the default allocator.
+ *
+ * Example usage:
+ *
+ * templet::DataBuilder builder;\n
+ * templet::DataMap data;\n
+ * data["name"] = builder.make("John");\n
+ * templet::parse("Hello, {$name}!", data, std::cout);
+ *
+ * Not thread-safe, use one builder per thread.
+ */
+class DataBuilder {
+private:
+    std::shared_ptr<types::Arena> _arena;
+
+    template <class T, class... Args>
+    types::DataPtr create(Args&&... args) {
+        return std::allocate_shared<T>(types::ArenaAllocator<T>(_arena), std::forward<Args>(args)...);
+    }
+
+public:
+    /**
+     * @brief Construct a DataBuilder
+     * @param blockSize Size of the arena blocks
+     */
+    explicit DataBuilder(std::size_t blockSize = 64 * 1024);
+
+    /**
+     * @brief Get the arena that the builder allocates from
+     * @return Arena
+     */
+    const types::Arena& arena() const;
+
+    /**
+     * @brief Wrap an integral type in a DataPtr
+     *
+     * Unsigned values that don't fit in a long long are wrapped as strings
+     *
+     * @param value Value to wrap
+     * @return Value wrapped in DataPtr
+     */
+    template <typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
+    types::DataPtr make(T value) {
+        if(!types::fits_integer(value)) {
+            return create<types::DataValue>(std::to_string(value));
+        }
+        return create<types::DataInteger>(static_cast<long long>(value));
+    }
+
+    /**
+     * @brief Wrap a floating point type in a DataPtr
+     * @param value Value to wrap
+     * @return Value wrapped in DataPtr
+     */
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value, types::DataPtr>::type make(T value) {
+        return create<types::DataFloat>(static_cast<double>(value));
+    }
+
+    /**
+     * @brief Wrap a string in a DataPtr
+     * @param value String to wrap
+     * @return Value wrapped in DataPtr
+     */
+    types::DataPtr make(std::string value);
+
+    /**
+     * @brief Wrap a DataVector in a DataPtr
+     * @param value Vector to wrap
+     * @return Value wrapped in DataPtr
+     */
+    types::DataPtr make(types::DataVector value);
+
+    /**
+     * @brief Wrap a vector of strings in a DataPtr
+     * @param value Vector of strings to wrap
+     * @return Value wrapped in DataPtr
+     */
+    types::DataPtr make(std::vector<std::string> value);
+
+    /**
+     * @brief Wrap a vector of strings in a DataPtr that stores them contiguously
+     *
+     * Like \link templet::make_string_list make_string_list \endlink
+     *
+     * @param value Vector of strings to wrap
+     * @return String list wrapped in DataPtr
+     */
+    types::DataPtr makeStringList(std::vector<std::string> value);
+
+    /**
+     * @brief Wrap a DataMap in a DataPtr
+     * @param value DataMap to wrap
+     * @return Value wrapped in DataPtr
+     */
+    types::DataPtr make(types::DataMap value);
+};
+
+} // namespace templet
+
+#endif // BUILDER_HPP
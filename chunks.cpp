@@ -0,0 +1,184 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include "chunks.hpp"
+
+using namespace templet;
+using namespace templet::nodes;
+
+namespace {
+
+/**
+ * @brief Stream buffer that appends to a string
+ */
+class StringBuffer : public std::streambuf {
+private:
+    std::string& _target;
+
+protected:
+    int_type overflow(int_type ch) override {
+        if(!traits_type::eq_int_type(ch, traits_type::eof())) {
+            _target.push_back(traits_type::to_char_type(ch));
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        _target.append(s, static_cast<std::size_t>(n));
+        return n;
+    }
+
+public:
+    explicit StringBuffer(std::string& target) : std::streambuf(), _target(target) {}
+};
+
+} // unnamed namespace
+
+ChunkRenderer::ChunkRenderer(std::vector<std::shared_ptr<Node>> nodes, const types::DataMap& values,
+                             std::size_t chunkSize)
+    : _nodes(new std::vector<std::shared_ptr<Node>>(std::move(nodes))),
+      _scope(new Scope(values)),
+      _frames(),
+      _chunkSize(chunkSize),
+      _pending(nullptr) {
+    push(*_nodes, _nodes->size(), _scope.get());
+}
+
+void ChunkRenderer::push(const std::vector<std::shared_ptr<Node>>& nodes, std::size_t end, const Scope* scope) {
+    _frames.push_back(Frame{&nodes, 0, end, scope, nullptr, {}, true, nullptr, nullptr});
+}
+
+bool ChunkRenderer::step(std::ostream& os, bool wait) {
+    auto& frame = _frames.back();
+    if(frame.index == frame.end) {
+        if(frame.loop) {
+            if(const auto item = frame.cursor->next()) {
+                // Bind the next element and repeat the block
+                const Scope itemScope(*frame.scope, frame.loop->alias(), item, frame.stable);
+                if(frame.itemScope) {
+                    *frame.itemScope = itemScope;
+                }
+                else {
+                    frame.itemScope.reset(new Scope(itemScope));
+                }
+                frame.index = 0;
+                return true;
+            }
+        }
+        _frames.pop_back();
+        return true;
+    }
+
+    const auto& node = *(*frame.nodes)[frame.index];
+    const Scope* scope = frame.loop ? frame.itemScope.get() : frame.scope;
+    if(node.type() == NodeType::IfValue) {
+        // Elif and else blocks are reached through the branch table,
+        // those found here are misplaced and throw when evaluated
+        std::size_t end = 0;
+        const auto body = static_cast<const IfValue&>(node).select(*scope, end, wait ? nullptr : &_pending);
+        if(_pending) {
+            // Stay at this node until the value is ready
+            return false;
+        }
+        ++frame.index;
+        if(body) {
+            push(body->children(), end, scope);
+        }
+        return true;
+    }
+
+    if(!wait) {
+        const auto path = node.path();
+        _pending = path ? runtime::pending(*path, *scope) : nullptr;
+        if(_pending) {
+            // Stay at this node until the value is ready
+            return false;
+        }
+    }
+    ++frame.index;
+    switch(node.type()) {
+    case NodeType::ForValue: {
+        const auto& loop = static_cast<const ForValue&>(node);
+        std::vector<types::DataPtr> keep;
+        bool stable = true;
+        auto cursor = loop.open(*scope, keep, &stable);
+        push(loop.children(), loop.children().size(), scope);
+        auto& inner = _frames.back();
+        inner.loop = &loop;
+        inner.keep.swap(keep);
+        inner.stable = stable;
+        inner.cursor = std::move(cursor);
+        // Start at the end so the first element is bound next
+        inner.index = inner.end;
+        break;
+    }
+    default:
+        node.evaluate(os, *scope);
+        break;
+    }
+    return true;
+}
+
+bool ChunkRenderer::fill(std::string& chunk, bool wait) {
+    chunk.clear();
+    _pending = nullptr;
+    StringBuffer buffer(chunk);
+    std::ostream os(&buffer);
+    try {
+        while(!_frames.empty() && chunk.size() < _chunkSize) {
+            if(!step(os, wait)) {
+                break;
+            }
+        }
+    }
+    catch(...) {
+        // The position is lost, there's nothing more to render
+        _frames.clear();
+        throw;
+    }
+
+    return !chunk.empty() || !_frames.empty();
+}
+
+bool ChunkRenderer::next(std::string& chunk) {
+    return fill(chunk, true);
+}
+
+bool ChunkRenderer::tryNext(std::string& chunk) {
+    return fill(chunk, false);
+}
+
+const types::Data* ChunkRenderer::pending() const {
+    return _pending;
+}
+
+bool ChunkRenderer::done() const {
+    return _frames.empty();
+}
@@ -0,0 +1,152 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef CHUNKS_HPP
+#define CHUNKS_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "nodes.hpp"
+#include "types.hpp"
+
+namespace templet {
+
+/**
+ * @brief The ChunkRenderer class renders a template a chunk at a time
+ *
+ * Each call to \link next \endlink renders until the chunk is full and
+ * returns, keeping its position in the node tree for the next call.
+ * The caller decides when to render more, e.g. when a socket becomes
+ * writable, so only one chunk of output is in memory at a time.
+ *
+ * Example usage:
+ *
+ * auto chunks = tpl.chunks(values);\n
+ * std::string chunk;\n
+ * while(chunks.next(chunk)) {\n
+ *     send(chunk);\n
+ * }
+ *
+ * The values are borrowed and must outlive the renderer.
+ */
+class ChunkRenderer {
+private:
+    /**
+     * @brief Position in the child nodes of one block
+     */
+    struct Frame {
+        const std::vector<std::shared_ptr<nodes::Node>>* nodes;
+        std::size_t index;
+        // Child nodes from here on aren't evaluated, e.g. the rest of an if chain
+        std::size_t end;
+        const nodes::Scope* scope;
+        // Set for for blocks
+        const nodes::ForValue* loop;
+        std::vector<types::DataPtr> keep;
+        bool stable;
+        std::unique_ptr<types::DataCursor> cursor;
+        std::unique_ptr<nodes::Scope> itemScope;
+    };
+
+    // Frames point to the nodes and the scope, so they don't move with the renderer
+    std::unique_ptr<const std::vector<std::shared_ptr<nodes::Node>>> _nodes;
+    std::unique_ptr<nodes::Scope> _scope;
+    std::vector<Frame> _frames;
+    std::size_t _chunkSize;
+    // Value that stopped the last tryNext
+    const types::Data* _pending;
+
+    void push(const std::vector<std::shared_ptr<nodes::Node>>& nodes, std::size_t end, const nodes::Scope* scope);
+
+    /**
+     * @brief Evaluate the next node of the innermost block
+     * @param os Output stream
+     * @param wait If false, a node is not evaluated while a value it reads isn't ready
+     * @return False if the node reads a value that isn't ready, otherwise true
+     */
+    bool step(std::ostream& os, bool wait);
+
+    bool fill(std::string& chunk, bool wait);
+
+public:
+    /**
+     * @brief Construct a ChunkRenderer
+     * @param nodes Nodes of the template
+     * @param values Map of key-value pairs for parsing the template
+     * @param chunkSize Size where a chunk is complete
+     */
+    ChunkRenderer(std::vector<std::shared_ptr<nodes::Node>> nodes, const types::DataMap& values,
+                  std::size_t chunkSize = 16384);
+
+    ChunkRenderer(ChunkRenderer&&) = default;
+    ChunkRenderer& operator=(ChunkRenderer&&) = default;
+
+    /**
+     * @brief Render the next chunk of output
+     *
+     * A chunk is at least chunkSize bytes except the last one. It can
+     * be longer by the output of one tag, which is never split.
+     *
+     * @param chunk Receives the chunk, its previous content is replaced
+     * @exception templet::exception::InvalidTagError if the template contains an invalid tag
+     * @exception templet::exception::MissingTagError if a for tag's list is not found
+     * @return False if the output was complete, otherwise true
+     */
+    bool next(std::string& chunk);
+
+    /**
+     * @brief Render the next chunk of output without waiting for values
+     *
+     * Like \link next \endlink, but rendering stops before a tag that
+     * reads a value that isn't ready, see \link types::Data::ready \endlink.
+     * The chunk can then be shorter than chunkSize or even empty, and
+     * \link pending \endlink returns the value.
+     *
+     * @param chunk Receives the chunk, its previous content is replaced
+     * @exception templet::exception::InvalidTagError if the template contains an invalid tag
+     * @exception templet::exception::MissingTagError if a for tag's list is not found
+     * @return False if the output was complete, otherwise true
+     */
+    bool tryNext(std::string& chunk);
+
+    /**
+     * @brief Get the value that stopped the last \link tryNext \endlink
+     * @return Value that isn't ready, or null if rendering wasn't stopped
+     */
+    const types::Data* pending() const;
+
+    /**
+     * @brief Check whether the output is complete
+     * @return True if there's nothing left to render
+     */
+    bool done() const;
+};
+
+} // namespace templet
+
+#endif // CHUNKS_HPP
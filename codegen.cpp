@@ -0,0 +1,307 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <vector>
+#include <stdexcept>
+#include "codegen.hpp"
+#include "nodes.hpp"
+#include "templet.hpp"
+
+using namespace templet;
+using namespace templet::nodes;
+
+namespace {
+
+/**
+ * @brief Quote a string as a C++ string literal
+ * @param text String to quote
+ * @return String literal
+ */
+std::string quote(const std::string& text) {
+    std::string result = "\"";
+    for(const char c : text) {
+        switch(c) {
+        case '"': result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '?': result += "\\?"; break;
+        case '\n': result += "\\n"; break;
+        case '\r': result += "\\r"; break;
+        case '\t': result += "\\t"; break;
+        default:
+            if(c >= 0x20 && c < 0x7f) {
+                result += c;
+            }
+            else {
+                // Three octal digits so that a following digit is not part of the escape
+                char escape[8];
+                std::snprintf(escape, sizeof(escape), "\\%03o", static_cast<unsigned char>(c));
+                result += escape;
+            }
+        }
+    }
+    return result + "\"";
+}
+
+bool is_identifier(const std::string& name) {
+    if(name.empty() || (name[0] >= '0' && name[0] <= '9')) {
+        return false;
+    }
+    for(const char c : name) {
+        if(!((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool is_branch(const Node& node) {
+    return node.type() == NodeType::ElifValue || node.type() == NodeType::ElseValue;
+}
+
+/**
+ * @brief The Names struct numbers tag names in the order they're first used
+ */
+struct Names {
+    std::map<std::string, std::size_t> index;
+    std::vector<std::string> list;
+    // Numbers of the names that are resolved as paths
+    std::set<std::size_t> paths;
+};
+
+/**
+ * @brief The Generator class writes the body of a render function for a node tree
+ *
+ * Tag names are collected into constants that are shared by all
+ * functions in the file. Names that are resolved are parsed into
+ * paths once, when the program starts.
+ */
+class Generator {
+private:
+    Names& _names;
+    std::ostream& _os;
+    int _scopes;
+    // Adjacent text blocks are written with one call
+    std::string _text;
+    int _textDepth;
+    bool _output;
+
+    std::string constant(const std::string& name) {
+        const auto it = _names.index.emplace(name, _names.list.size()).first;
+        if(it->second == _names.list.size()) {
+            _names.list.push_back(name);
+        }
+        return "name" + std::to_string(it->second);
+    }
+
+    std::string path(const std::string& name) {
+        constant(name);
+        const auto number = _names.index[name];
+        _names.paths.insert(number);
+        return "path" + std::to_string(number);
+    }
+
+    void indent(int depth) {
+        _os << std::string(static_cast<std::size_t>(depth) * 4, ' ');
+    }
+
+    void line(int depth, const std::string& code) {
+        flush();
+        indent(depth);
+        _os << code << '\n';
+    }
+
+    void invalid(int depth, const char* message) {
+        line(depth, std::string("throw templet::exception::InvalidTagError(") + quote(message) + ");");
+    }
+
+    bool hasIfParent(const Node& node) {
+        return node.parent() && (node.parent()->type() == NodeType::IfValue ||
+                                 node.parent()->type() == NodeType::ElifValue);
+    }
+
+    void ifValue(const IfValue& node, int depth, const std::string& scope) {
+        line(depth, "if(templet::nodes::runtime::is_set(" + path(node.name()) + ", " + scope + ")) {");
+        for(const auto& child : node.children()) {
+            if(is_branch(*child)) {
+                break;
+            }
+            write(*child, depth + 1, scope);
+        }
+        line(depth, "}");
+        const auto& children = node.children();
+        if(std::none_of(children.cbegin(), children.cend(), [](const std::shared_ptr<Node>& child){
+            return is_branch(*child);
+        })) {
+            return;
+        }
+        line(depth, "else {");
+        for(const auto& child : children) {
+            if(is_branch(*child)) {
+                write(*child, depth + 1, scope);
+            }
+        }
+        line(depth, "}");
+    }
+
+    void forValue(const ForValue& node, int depth, const std::string& scope) {
+        const auto id = std::to_string(++_scopes);
+        const auto itemScope = "scope" + id;
+        line(depth, "{");
+        line(depth + 1, "std::vector<templet::types::DataPtr> keep" + id + ";");
+        line(depth + 1, "bool stable" + id + " = true;");
+        line(depth + 1, "const auto cursor" + id + " = templet::nodes::runtime::open_cursor(" +
+             path(node.name()) + ", " + constant(node.alias()) + ", " + scope + ", keep" + id +
+             ", &stable" + id + ");");
+        line(depth + 1, "while(const auto item" + id + " = cursor" + id + "->next()) {");
+        line(depth + 2, "const templet::nodes::Scope " + itemScope + "(" + scope + ", " +
+             constant(node.alias()) + ", item" + id + ", stable" + id + ");");
+        for(const auto& child : node.children()) {
+            write(*child, depth + 2, itemScope);
+        }
+        line(depth + 1, "}");
+        line(depth, "}");
+    }
+
+public:
+    Generator(Names& names, std::ostream& os)
+        : _names(names), _os(os), _scopes(0), _text(), _textDepth(0), _output(false) {}
+
+    /**
+     * @brief Check if the generated code writes to the output stream
+     * @return True if it writes, otherwise false
+     */
+    bool writesOutput() const {
+        return _output;
+    }
+
+    /**
+     * @brief Write the pending text blocks
+     */
+    void flush() {
+        if(_text.empty()) {
+            return;
+        }
+        _output = true;
+        indent(_textDepth);
+        _os << "os.write(" << quote(_text) << ", " << _text.size() << ");\n";
+        _text.clear();
+    }
+
+    void write(const Node& node, int depth, const std::string& scope) {
+        switch(node.type()) {
+        case NodeType::Text: {
+            if(_text.empty()) {
+                _textDepth = depth;
+            }
+            _text += static_cast<const Text&>(node).text();
+            break;
+        }
+        case NodeType::Value:
+            _output = true;
+            line(depth, "templet::nodes::runtime::write_value(os, " +
+                 path(static_cast<const Value&>(node).name()) + ", " + scope + ");");
+            break;
+        case NodeType::IfValue:
+            ifValue(static_cast<const IfValue&>(node), depth, scope);
+            break;
+        case NodeType::ElifValue:
+            if(!hasIfParent(node)) {
+                invalid(depth, "ELIF statements cannot be declared without a preceding IF statement");
+                break;
+            }
+            ifValue(static_cast<const IfValue&>(node), depth, scope);
+            break;
+        case NodeType::ElseValue:
+            if(!hasIfParent(node)) {
+                invalid(depth, "ELSE statements cannot be declared without a preceding IF or ELIF statement");
+                break;
+            }
+            for(const auto& child : node.children()) {
+                write(*child, depth, scope);
+            }
+            break;
+        case NodeType::ForValue:
+            forValue(static_cast<const ForValue&>(node), depth, scope);
+            break;
+        default:
+            throw std::runtime_error("Unknown node type");
+        }
+    }
+};
+
+} // unnamed namespace
+
+void templet::generate_cpp(const std::vector<std::pair<std::string, std::string>>& templates, std::ostream& os) {
+    Names names;
+    std::ostringstream functions;
+    for(const auto& tpl : templates) {
+        if(!is_identifier(tpl.first)) {
+            throw std::runtime_error("Invalid function name: " + tpl.first);
+        }
+        auto text = tpl.second;
+        const auto nodes = tokenize(text);
+
+        std::ostringstream body;
+        Generator generator(names, body);
+        for(const auto& node : nodes) {
+            generator.write(*node, 1, "scope0");
+        }
+        generator.flush();
+
+        functions << "\nvoid " << tpl.first << "(std::ostream& " << (generator.writesOutput() ? "os" : "/*os*/")
+                  << ", const templet::DataMap& values) {\n"
+                  << "    const templet::nodes::Scope scope0(values);\n"
+                  << body.str()
+                  << "}\n";
+    }
+
+    os << "// Generated by templetc, do not edit\n\n"
+       << "#include <memory>\n"
+       << "#include <ostream>\n"
+       << "#include <string>\n"
+       << "#include <vector>\n"
+       << "#include \"nodes.hpp\"\n";
+    if(!names.list.empty()) {
+        os << "\nnamespace {\n\n";
+        for(std::size_t i = 0; i < names.list.size(); ++i) {
+            os << "const std::string name" << i << " = " << quote(names.list[i]) << ";\n";
+        }
+        if(!names.paths.empty()) {
+            os << "\n";
+        }
+        for(const auto i : names.paths) {
+            os << "const templet::nodes::Path path" << i << "(name" << i << ");\n";
+        }
+        os << "\n} // unnamed namespace\n";
+    }
+    os << functions.str();
+}
@@ -0,0 +1,63 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef CODEGEN_HPP
+#define CODEGEN_HPP
+
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace templet {
+
+/**
+ * @brief Generate C++ source code that renders templates
+ *
+ * Each template becomes a function with the signature
+ *
+ * void name(std::ostream& os, const templet::DataMap& values);
+ *
+ * that appends text blocks directly and evaluates tags with the same
+ * rules as the interpreter, with the template structure compiled into
+ * ifs and loops. The generated file includes nodes.hpp and must be
+ * linked with the library.
+ *
+ * Example usage:
+ *
+ * std::ofstream out {"templates.cpp"};\n
+ * templet::generate_cpp({{"render_page", templet::helpers::FileReader::fromFile("page.tpl")}}, out);
+ *
+ * @param templates Pairs of function name and template text
+ * @param os Output stream for the source code
+ * @exception std::runtime_error if a function name is not a valid identifier
+ * @exception templet::exception::InvalidTagError if a template contains an invalid tag
+ */
+void generate_cpp(const std::vector<std::pair<std::string, std::string>>& templates, std::ostream& os);
+
+} // namespace templet
+
+#endif // CODEGEN_HPP
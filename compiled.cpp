@@ -0,0 +1,387 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include "compiled.hpp"
+#include "nodes.hpp"
+
+using namespace templet;
+using namespace templet::nodes;
+
+namespace {
+
+/*
+ * Image layout. All integers are 32-bit in the byte order of the writer
+ * and all records start at a multiple of 4 bytes.
+ *
+ * Header:  magic[8] version byte_order count size
+ * Entry:   name_offset name_length text_length checksum_low checksum_high nodes_offset
+ * String:  length bytes
+ * Nodes:   count node[count]
+ * Node:    kind, then by kind
+ *          Text:  offset length (range of the template text)
+ *          Value: String (name)
+ *          If:    String (name) Nodes
+ *          Elif:  String (name) Nodes
+ *          Else:  Nodes
+ *          For:   String (name) String (alias) Nodes
+ *
+ * Entries follow the header and are sorted by name. The checksum is
+ * the 64-bit FNV-1a hash of the template text.
+ */
+
+const char Magic[8] = {'T', 'E', 'M', 'P', 'L', 'E', 'T', 'C'};
+const std::uint32_t Version = 3;
+const std::uint32_t ByteOrder = 0x01020304;
+const std::size_t HeaderSize = sizeof(Magic) + 4 * sizeof(std::uint32_t);
+const std::size_t EntrySize = 6 * sizeof(std::uint32_t);
+// Deepest nesting of blocks that is written and read, so that a corrupt
+// image can't exhaust the stack
+const std::size_t MaxDepth = 512;
+
+enum Kind : std::uint32_t {
+    KindText = 0,
+    KindValue = 1,
+    KindIf = 2,
+    KindElif = 3,
+    KindElse = 4,
+    KindFor = 5
+};
+
+std::uint64_t checksum(const std::string& text) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for(const char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+std::uint32_t checked_size(std::size_t size) {
+    if(size > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Compiled template image is too large");
+    }
+    return static_cast<std::uint32_t>(size);
+}
+
+void put_u32(std::string& out, std::uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void set_u32(std::string& out, std::size_t offset, std::uint32_t value) {
+    std::memcpy(&out[offset], &value, sizeof(value));
+}
+
+void put_string(std::string& out, const std::string& text) {
+    put_u32(out, checked_size(text.size()));
+    out += text;
+    out.append((4 - out.size() % 4) % 4, '\0');
+}
+
+/**
+ * @brief Write nodes
+ * @param out Image
+ * @param source Template text that the text nodes refer to
+ * @param nodes Nodes to write
+ * @param depth Number of blocks the nodes are in
+ * @exception std::runtime_error if the blocks are nested more than MaxDepth deep
+ */
+void put_nodes(std::string& out, const std::string& source, const std::vector<std::shared_ptr<Node>>& nodes,
+               std::size_t depth = 0) {
+    if(depth > MaxDepth) {
+        throw std::runtime_error("Template is nested too deeply to compile");
+    }
+    put_u32(out, checked_size(nodes.size()));
+    for(const auto& node : nodes) {
+        switch(node->type()) {
+        case NodeType::Text: {
+            const auto& text = static_cast<const Text&>(*node);
+            put_u32(out, KindText);
+            put_u32(out, checked_size(static_cast<std::size_t>(text.data() - source.data())));
+            put_u32(out, checked_size(text.size()));
+            break;
+        }
+        case NodeType::Value:
+            put_u32(out, KindValue);
+            put_string(out, static_cast<const Value&>(*node).name());
+            break;
+        case NodeType::IfValue:
+        case NodeType::ElifValue:
+            put_u32(out, node->type() == NodeType::IfValue ? KindIf : KindElif);
+            put_string(out, static_cast<const IfValue&>(*node).name());
+            put_nodes(out, source, node->children(), depth + 1);
+            break;
+        case NodeType::ElseValue:
+            put_u32(out, KindElse);
+            put_nodes(out, source, node->children(), depth + 1);
+            break;
+        case NodeType::ForValue:
+            put_u32(out, KindFor);
+            put_string(out, static_cast<const ForValue&>(*node).name());
+            put_string(out, static_cast<const ForValue&>(*node).alias());
+            put_nodes(out, source, node->children(), depth + 1);
+            break;
+        default:
+            throw std::runtime_error("Unknown node type");
+        }
+    }
+}
+
+/**
+ * @brief The Reader class reads records of an image with bounds checks
+ */
+class Reader {
+private:
+    const char* _data;
+    std::size_t _size;
+    std::size_t _pos;
+    std::shared_ptr<const std::string> _source;
+
+    void require(std::size_t length) const {
+        if(_pos > _size || _size - _pos < length) {
+            throw std::runtime_error("Compiled template image is corrupt");
+        }
+    }
+
+public:
+    /**
+     * @brief Construct a reader
+     * @param data Image
+     * @param size Size of the image
+     * @param pos Position to read from
+     * @param source Template text that text nodes refer to
+     */
+    Reader(const char* data, std::size_t size, std::size_t pos,
+           std::shared_ptr<const std::string> source = nullptr)
+        : _data(data), _size(size), _pos(pos), _source(std::move(source)) {}
+
+    std::uint32_t u32() {
+        require(sizeof(std::uint32_t));
+        std::uint32_t value;
+        std::memcpy(&value, _data + _pos, sizeof(value));
+        _pos += sizeof(value);
+        return value;
+    }
+
+    std::string string() {
+        const auto length = u32();
+        require(length);
+        std::string text(_data + _pos, length);
+        _pos += (length + 3) / 4 * 4;
+        return text;
+    }
+
+    std::vector<std::shared_ptr<Node>> nodes(std::size_t depth = 0) {
+        if(depth > MaxDepth) {
+            throw std::runtime_error("Compiled template image is corrupt");
+        }
+        const auto count = u32();
+        // Every node takes at least 8 bytes
+        require(static_cast<std::size_t>(count) * 8);
+        std::vector<std::shared_ptr<Node>> result;
+        result.reserve(count);
+        for(std::uint32_t i = 0; i < count; ++i) {
+            std::shared_ptr<Node> node;
+            switch(u32()) {
+            case KindText: {
+                const auto offset = u32();
+                const auto length = u32();
+                if(offset > _source->size() || _source->size() - offset < length) {
+                    throw std::runtime_error("Compiled template image is corrupt");
+                }
+                result.push_back(std::make_shared<Text>(_source, offset, length));
+                continue;
+            }
+            case KindValue:
+                result.push_back(std::make_shared<Value>(string()));
+                continue;
+            case KindIf:
+                node = std::make_shared<IfValue>(string());
+                break;
+            case KindElif:
+                node = std::make_shared<ElifValue>(string());
+                break;
+            case KindElse:
+                node = std::make_shared<ElseValue>();
+                break;
+            case KindFor: {
+                auto name = string();
+                node = std::make_shared<ForValue>(std::move(name), string());
+                break;
+            }
+            default:
+                throw std::runtime_error("Compiled template image is corrupt");
+            }
+            node->setChildren(nodes(depth + 1));
+            result.push_back(std::move(node));
+        }
+        return result;
+    }
+};
+
+} // unnamed namespace
+
+CompiledTemplates::CompiledTemplates() : _file() {
+
+}
+
+void CompiledTemplates::load() {
+    const auto data = _file.data();
+    const auto size = _file.size();
+    if(size < HeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+        throw std::runtime_error("Not a compiled template image");
+    }
+    Reader header(data, size, sizeof(Magic));
+    if(header.u32() != Version) {
+        throw std::runtime_error("Unsupported compiled template version");
+    }
+    if(header.u32() != ByteOrder) {
+        throw std::runtime_error("Compiled template image has a different byte order");
+    }
+    const auto entries = header.u32();
+    if(header.u32() != size) {
+        throw std::runtime_error("Compiled template image is truncated");
+    }
+    if((size - HeaderSize) / EntrySize < entries) {
+        throw std::runtime_error("Compiled template image is corrupt");
+    }
+}
+
+std::uint32_t CompiledTemplates::find(const std::string& name, const std::string& text) const {
+    const auto data = _file.data();
+    const auto size = _file.size();
+    std::size_t first = 0;
+    std::size_t last = count();
+    while(first < last) {
+        const auto middle = first + (last - first) / 2;
+        Reader entry(data, size, HeaderSize + middle * EntrySize);
+        const auto nameOffset = entry.u32();
+        const auto nameLength = entry.u32();
+        if(nameOffset > size || size - nameOffset < nameLength) {
+            throw std::runtime_error("Compiled template image is corrupt");
+        }
+        const auto compare = name.compare(0, std::string::npos, data + nameOffset, nameLength);
+        if(compare < 0) {
+            last = middle;
+        }
+        else if(compare > 0) {
+            first = middle + 1;
+        }
+        else {
+            const auto textLength = entry.u32();
+            const std::uint64_t low = entry.u32();
+            const std::uint64_t high = entry.u32();
+            const auto nodes = entry.u32();
+            if(textLength != text.size() || (low | high << 32) != checksum(text)) {
+                return 0;
+            }
+            return nodes;
+        }
+    }
+    return 0;
+}
+
+std::unique_ptr<CompiledTemplates> CompiledTemplates::fromFile(const std::string& path) {
+    std::unique_ptr<CompiledTemplates> compiled(new CompiledTemplates);
+    compiled->_file.open(path);
+    compiled->load();
+    return compiled;
+}
+
+std::unique_ptr<CompiledTemplates> CompiledTemplates::fromImage(std::string image) {
+    std::unique_ptr<CompiledTemplates> compiled(new CompiledTemplates);
+    compiled->_file.assign(std::move(image));
+    compiled->load();
+    return compiled;
+}
+
+bool CompiledTemplates::contains(const std::string& name, const std::string& text) const {
+    return find(name, text) != 0;
+}
+
+Templet CompiledTemplates::get(const std::string& name, std::string text) const {
+    const auto offset = find(name, text);
+    if(offset == 0) {
+        return Templet(std::move(text));
+    }
+    const auto source = std::make_shared<const std::string>(std::move(text));
+    Reader reader(_file.data(), _file.size(), offset, source);
+    auto nodes = reader.nodes();
+    return Templet(source, std::move(nodes));
+}
+
+std::size_t CompiledTemplates::count() const {
+    Reader header(_file.data(), _file.size(), 16);
+    return header.u32();
+}
+
+void templet::save_compiled(const std::vector<std::pair<std::string, std::string>>& templates, std::ostream& os) {
+    std::vector<const std::pair<std::string, std::string>*> sorted;
+    sorted.reserve(templates.size());
+    for(const auto& tpl : templates) {
+        sorted.push_back(&tpl);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const std::pair<std::string, std::string>* lhs,
+                                               const std::pair<std::string, std::string>* rhs) {
+        return lhs->first < rhs->first;
+    });
+    const auto duplicate = std::adjacent_find(sorted.cbegin(), sorted.cend(),
+            [](const std::pair<std::string, std::string>* lhs, const std::pair<std::string, std::string>* rhs) {
+        return lhs->first == rhs->first;
+    });
+    if(duplicate != sorted.cend()) {
+        throw std::runtime_error("Template name is used twice: " + (*duplicate)->first);
+    }
+
+    std::string out(HeaderSize + sorted.size() * EntrySize, '\0');
+    for(std::size_t i = 0; i < sorted.size(); ++i) {
+        const auto& name = sorted[i]->first;
+        const auto& text = sorted[i]->second;
+        const auto source = std::make_shared<const std::string>(text);
+        const auto nodes = templet::tokenize(source);
+        const auto entry = HeaderSize + i * EntrySize;
+        const auto hash = checksum(text);
+        set_u32(out, entry, checked_size(out.size() + sizeof(std::uint32_t)));
+        put_string(out, name);
+        set_u32(out, entry + 4, checked_size(name.size()));
+        set_u32(out, entry + 8, checked_size(text.size()));
+        set_u32(out, entry + 12, static_cast<std::uint32_t>(hash));
+        set_u32(out, entry + 16, static_cast<std::uint32_t>(hash >> 32));
+        set_u32(out, entry + 20, checked_size(out.size()));
+        put_nodes(out, *source, nodes);
+    }
+    std::memcpy(&out[0], Magic, sizeof(Magic));
+    set_u32(out, 8, Version);
+    set_u32(out, 12, ByteOrder);
+    set_u32(out, 16, checked_size(sorted.size()));
+    set_u32(out, 20, checked_size(out.size()));
+    os.write(out.data(), static_cast<std::streamsize>(out.size()));
+}
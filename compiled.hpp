@@ -0,0 +1,140 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef COMPILED_HPP
+#define COMPILED_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "mapping.hpp"
+#include "templet.hpp"
+
+namespace templet {
+
+/**
+ * @brief The CompiledTemplates class creates templates from a binary image of their nodes
+ *
+ * Loading a template from the image skips tokenizing its text. Every
+ * template in the image has the checksum of the text it was compiled
+ * from. A template whose text has changed since is tokenized as usual,
+ * so a stale image is slower but never wrong.
+ *
+ * Example usage:
+ *
+ * std::ofstream out {"templates.bin", std::ios::binary};\n
+ * templet::save_compiled({{"page", page_text}}, out);\n
+ * ...\n
+ * auto compiled = templet::CompiledTemplates::fromFile("templates.bin");\n
+ * auto page = compiled->get("page", page_text);
+ *
+ * Images can only be loaded on machines with the same byte order.
+ */
+class CompiledTemplates {
+private:
+    helpers::MappedFile _file;
+
+    CompiledTemplates();
+
+    /**
+     * @brief Validate the image header
+     * @exception std::runtime_error if the image is invalid
+     */
+    void load();
+
+    /**
+     * @brief Find the nodes of a template
+     * @param name Name of the template
+     * @param text Template text
+     * @return Offset of the nodes, or 0 if the image has no template with the name and text
+     */
+    std::uint32_t find(const std::string& name, const std::string& text) const;
+
+public:
+    CompiledTemplates(const CompiledTemplates&) = delete;
+    CompiledTemplates& operator=(const CompiledTemplates&) = delete;
+
+    /**
+     * @brief Load compiled templates from a file
+     * @param path Path to file
+     * @exception std::runtime_error if the file can't be opened or is not a valid image
+     * @return Loaded templates
+     */
+    static std::unique_ptr<CompiledTemplates> fromFile(const std::string& path);
+
+    /**
+     * @brief Load compiled templates from an image in memory
+     * @param image Image written by \link save_compiled \endlink
+     * @exception std::runtime_error if the image is not valid
+     * @return Loaded templates
+     */
+    static std::unique_ptr<CompiledTemplates> fromImage(std::string image);
+
+    /**
+     * @brief Check if the image has an up to date template
+     * @param name Name of the template
+     * @param text Template text
+     * @return True if the template was compiled from the same text, otherwise false
+     */
+    bool contains(const std::string& name, const std::string& text) const;
+
+    /**
+     * @brief Create a Templet object
+     *
+     * The nodes are read from the image if it contains the template,
+     * otherwise the text is tokenized when the template is first parsed.
+     *
+     * @param name Name of the template
+     * @param text Template text
+     * @exception std::runtime_error if the image is corrupt
+     * @return Templet object
+     */
+    Templet get(const std::string& name, std::string text) const;
+
+    /**
+     * @brief Get the number of templates in the image
+     * @return Number of templates
+     */
+    std::size_t count() const;
+};
+
+/**
+ * @brief Write a binary image of tokenized templates that \link CompiledTemplates \endlink can load
+ * @param templates Pairs of template name and template text
+ * @param os Output, must be opened in binary mode
+ * @exception std::runtime_error if a name is used twice, blocks are nested more than
+ * 512 deep or the image would exceed 4 GB
+ * @exception templet::exception::InvalidTagError if a template contains an invalid tag
+ */
+void save_compiled(const std::vector<std::pair<std::string, std::string>>& templates, std::ostream& os);
+
+} // namespace templet
+
+#endif // COMPILED_HPP
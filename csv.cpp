@@ -0,0 +1,240 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "csv.hpp"
+#include "ptrutil.hpp"
+
+using namespace templet;
+using namespace templet::types;
+
+namespace {
+
+/**
+ * @brief The FieldRef class refers to a field of a CsvRow
+ */
+class FieldRef : public Data {
+private:
+    const std::string* _value;
+
+public:
+    FieldRef(const std::string* value) : _value(value) {}
+
+    bool empty() const override {
+        return _value->empty();
+    }
+
+    std::string getValue() const override {
+        return *_value;
+    }
+
+    DataType type() const override {
+        return DataType::String;
+    }
+};
+
+/**
+ * @brief The CsvRow class is a map of the current CSV record
+ *
+ * The fields are overwritten by every record, the FieldRefs that
+ * refer to them and the map of them are created once.
+ */
+class CsvRow : public Data {
+private:
+    std::vector<std::string> _fields;
+    DataMap _map;
+
+public:
+    /**
+     * @brief Construct a CsvRow
+     * @param columns Column names from the header
+     * @exception std::runtime_error if a column name is repeated
+     */
+    CsvRow(const std::vector<std::string>& columns)
+        : _fields(columns.size()), _map() {
+        for(std::size_t column = 0; column < columns.size(); ++column) {
+            if(!_map.emplace(columns[column], std::make_shared<FieldRef>(&_fields[column])).second) {
+                throw std::runtime_error("CSV header has a duplicate column " + columns[column]);
+            }
+        }
+    }
+
+    std::vector<std::string>& fields() {
+        return _fields;
+    }
+
+    bool empty() const override {
+        return _map.empty();
+    }
+
+    const DataMap& getMap() const override {
+        return _map;
+    }
+
+    const Data* getItem(const std::string& key, DataPtr& /*holder*/) const override {
+        const auto it = _map.find(key);
+        return it != _map.end() ? it->second.get() : nullptr;
+    }
+
+    DataType type() const override {
+        return DataType::Mapper;
+    }
+};
+
+/**
+ * @brief Read a CSV record
+ * @param in Input
+ * @param separator Field separator
+ * @param line Buffer for the lines of the record
+ * @param fields Fields of the record, existing strings are reused
+ * @param limit Maximum number of fields, fields never grows beyond it
+ * @exception std::runtime_error if the record has more than limit fields
+ * @return Number of fields, or 0 at the end of the input
+ */
+std::size_t read_record(std::istream& in, char separator, std::string& line, std::vector<std::string>& fields,
+                        std::size_t limit) {
+    // Blank lines are skipped
+    do {
+        if(!std::getline(in, line)) {
+            return 0;
+        }
+        if(!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+    } while(line.empty());
+
+    std::size_t count = 0;
+    std::string* field = nullptr;
+    bool quoted = false;
+    std::size_t pos = 0;
+    while(true) {
+        if(!field) {
+            if(count == limit) {
+                throw std::runtime_error("CSV row has more fields than the header");
+            }
+            if(count == fields.size()) {
+                fields.emplace_back();
+            }
+            field = &fields[count++];
+            field->clear();
+        }
+        if(pos == line.size()) {
+            if(!quoted) {
+                break;
+            }
+            // A quoted field continues on the next line
+            if(!std::getline(in, line)) {
+                break;
+            }
+            if(!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            *field += '\n';
+            pos = 0;
+            continue;
+        }
+        const char c = line[pos++];
+        if(quoted) {
+            if(c != '"') {
+                *field += c;
+            }
+            else if(pos < line.size() && line[pos] == '"') {
+                *field += '"';
+                ++pos;
+            }
+            else {
+                quoted = false;
+            }
+        }
+        else if(c == separator) {
+            field = nullptr;
+        }
+        else if(c == '"' && field->empty()) {
+            quoted = true;
+        }
+        else {
+            *field += c;
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief The CsvCursor class reads the rows of CSV input
+ *
+ * The same CsvRow is returned for every row
+ */
+class CsvCursor : public DataCursor {
+private:
+    std::unique_ptr<std::istream> _in;
+    char _separator;
+    std::string _line;
+    std::unique_ptr<CsvRow> _row;
+
+public:
+    CsvCursor(std::unique_ptr<std::istream> in, char separator)
+        : _in(std::move(in)), _separator(separator), _line(), _row() {
+        std::vector<std::string> columns;
+        columns.resize(read_record(*_in, _separator, _line, columns, std::numeric_limits<std::size_t>::max()));
+        _row = mylib::make_unique<CsvRow>(columns);
+    }
+
+    const Data* next() override {
+        // The row's FieldRefs point into fields, so it must not grow
+        auto& fields = _row->fields();
+        const auto columns = fields.size();
+        const auto count = read_record(*_in, _separator, _line, fields, columns);
+        if(count == 0) {
+            return nullptr;
+        }
+        for(auto column = count; column < columns; ++column) {
+            fields[column].clear();
+        }
+        return _row.get();
+    }
+};
+
+} // unnamed namespace
+
+DataPtr templet::make_csv_stream(std::function<std::unique_ptr<std::istream>()> open, char separator) {
+    return make_stream([open, separator]{
+        return mylib::make_unique<CsvCursor>(open(), separator);
+    });
+}
+
+DataPtr templet::make_csv_stream(const std::string& path, char separator) {
+    return make_csv_stream([path]() -> std::unique_ptr<std::istream> {
+        std::unique_ptr<std::istream> in(new std::ifstream(path, std::ios::binary));
+        if(!*in) {
+            throw std::runtime_error("Unable to open file " + path);
+        }
+        return in;
+    }, separator);
+}
@@ -0,0 +1,75 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef CSV_HPP
+#define CSV_HPP
+
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include "types.hpp"
+
+namespace templet {
+
+/**
+ * @brief Stream the rows of CSV input
+ *
+ * The first record is the header, the following records are rows
+ * that are maps from column names to fields. Fields may be quoted
+ * with double quotes, which may contain separators, line breaks and
+ * doubled quotes. Missing fields are empty.
+ *
+ * Rows are read one at a time for each traversal and the same map is
+ * reused for every row, so memory use doesn't grow with the input.
+ *
+ * Example usage:
+ *
+ * data["rows"] = templet::make_csv_stream("export.csv");\n
+ * templet::Templet tpl("{% for rows as row %}{$ row.name },{$ row.email }\n{% endfor %}");\n
+ * tpl.render(data, std::cout);
+ *
+ * @param open Callback that opens the input for each traversal
+ * @param separator Field separator
+ * @exception std::runtime_error while rendering, if the header repeats a column name
+ * or a row has more fields than the header
+ * @return Stream wrapped in DataPtr
+ */
+types::DataPtr make_csv_stream(std::function<std::unique_ptr<std::istream>()> open, char separator = ',');
+
+/**
+ * @brief Stream the rows of a CSV file
+ * @param path Path to file
+ * @param separator Field separator
+ * @exception std::runtime_error while rendering, if the file can't be opened, the
+ * header repeats a column name or a row has more fields than the header
+ * @return Stream wrapped in DataPtr
+ */
+types::DataPtr make_csv_stream(const std::string& path, char separator = ',');
+
+} // namespace templet
+
+#endif // CSV_HPP
@@ -0,0 +1,173 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include "file.hpp"
+#include "mapping.hpp"
+#include "segments.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TEMPLET_FILE_DESCRIPTORS
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace templet;
+using namespace templet::types;
+
+namespace {
+
+/**
+ * @brief The OpenFile class keeps a file open and maps it on demand
+ *
+ * The file is mapped once, guarded by std::call_once, so renders in
+ * different threads can share it.
+ */
+class OpenFile {
+private:
+    std::string _path;
+    int _fd;
+    std::uint64_t _size;
+    helpers::MappedFile _mapping;
+    std::once_flag _mapOnce;
+
+public:
+    explicit OpenFile(std::string path)
+        : _path(std::move(path)), _fd(-1), _size(0), _mapping(), _mapOnce() {
+#ifdef TEMPLET_FILE_DESCRIPTORS
+        _fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if(_fd == -1) {
+            throw std::runtime_error("Unable to open file " + _path);
+        }
+        struct stat info;
+        if(::fstat(_fd, &info) == -1) {
+            ::close(_fd);
+            throw std::runtime_error("Unable to read file " + _path);
+        }
+        _size = static_cast<std::uint64_t>(info.st_size);
+#else
+        std::ifstream file {_path, std::ios::binary | std::ios::ate};
+        if(!file) {
+            throw std::runtime_error("Unable to open file " + _path);
+        }
+        _size = static_cast<std::uint64_t>(file.tellg());
+#endif
+    }
+
+    OpenFile(const OpenFile&) = delete;
+    OpenFile& operator=(const OpenFile&) = delete;
+
+    ~OpenFile() {
+#ifdef TEMPLET_FILE_DESCRIPTORS
+        ::close(_fd);
+#endif
+    }
+
+    /**
+     * @brief Get the descriptor
+     * @return Descriptor, or -1 if the platform has none
+     */
+    int fd() const {
+        return _fd;
+    }
+
+    std::uint64_t size() const {
+        return _size;
+    }
+
+    /**
+     * @brief Map the file if it's not mapped yet
+     * @return Start of the file in memory
+     */
+    const char* data() {
+        std::call_once(_mapOnce, [this]{
+            _mapping.open(_path);
+        });
+        if(_mapping.size() < _size) {
+            throw std::runtime_error("File is shorter than its value: " + _path);
+        }
+        return _mapping.data();
+    }
+};
+
+/**
+ * @brief The DataFile class is a string value read from a region of a file
+ */
+class DataFile final : public Data {
+private:
+    std::shared_ptr<OpenFile> _file;
+    std::uint64_t _offset;
+    std::size_t _size;
+
+public:
+    DataFile(std::shared_ptr<OpenFile> file, std::uint64_t offset, std::size_t size)
+        : _file(std::move(file)), _offset(offset), _size(size) {}
+
+    bool empty() const override {
+        return _size == 0;
+    }
+
+    std::string getValue() const override {
+        return std::string(_file->data() + _offset, _size);
+    }
+
+    void write(std::ostream& os) const override {
+        if(_size == 0) {
+            return;
+        }
+        const auto segments = segment_stream(os);
+        if(segments && !segments->copying() && _file->fd() != -1) {
+            segments->file(_file->fd(), _offset, _size);
+        }
+        else {
+            write_stable(os, _file->data() + _offset, _size);
+        }
+    }
+
+    DataType type() const override {
+        return DataType::String;
+    }
+};
+
+} // unnamed namespace
+
+DataPtr templet::make_file_data(const std::string& path, std::uint64_t offset, std::uint64_t size) {
+    auto file = std::make_shared<OpenFile>(path);
+    if(offset > file->size()) {
+        throw std::runtime_error("File region is out of range: " + path);
+    }
+    const auto length = std::min(size, file->size() - offset);
+    if(length > std::numeric_limits<std::size_t>::max()) {
+        throw std::runtime_error("File region is too large: " + path);
+    }
+    return std::make_shared<DataFile>(std::move(file), offset, static_cast<std::size_t>(length));
+}
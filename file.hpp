@@ -0,0 +1,67 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef FILE_HPP
+#define FILE_HPP
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include "types.hpp"
+
+namespace templet {
+
+/**
+ * @brief Refer to a region of a file as a string value
+ *
+ * The file is not read when the value is created. Rendered into a
+ * \link SegmentStream \endlink, the value is a file segment that
+ * \link write_segments \endlink copies to its descriptor in the kernel.
+ * Rendered into other streams, the file is mapped into memory and
+ * written from there.
+ *
+ * Example usage:
+ *
+ * data["attachment"] = templet::make_file_data("report.html");\n
+ * templet::SegmentStream out;\n
+ * tpl.render(data, out);\n
+ * templet::write_segments(socket, out.segments());
+ *
+ * The file stays open while the value exists. It must not shrink while
+ * it's rendered.
+ *
+ * @param path Path to file
+ * @param offset Start of the region
+ * @param size Length of the region, the region ends at the end of the file if it's longer
+ * @exception std::runtime_error if the file can't be opened or offset is past its end
+ * @return Value wrapped in DataPtr
+ */
+types::DataPtr make_file_data(const std::string& path, std::uint64_t offset = 0,
+                              std::uint64_t size = std::numeric_limits<std::uint64_t>::max());
+
+} // namespace templet
+
+#endif // FILE_HPP
@@ -0,0 +1,672 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "json.hpp"
+#include "ptrutil.hpp"
+
+using namespace templet;
+using namespace templet::types;
+
+namespace {
+
+enum Kind : std::uint32_t {
+    KindNull,
+    KindFalse,
+    KindTrue,
+    KindInteger,
+    KindFloat,
+    KindString,
+    KindEscapedString,
+    KindArray,
+    KindObject
+};
+
+/**
+ * @brief The Entry struct is a parsed JSON value
+ *
+ * Strings and numbers refer to their text by begin and length.
+ * The elements of arrays and the keys and values of objects follow
+ * the container, in which case length is the number of elements or
+ * members. end is the index after the value and its elements.
+ */
+struct Entry {
+    Kind kind;
+    std::uint32_t begin;
+    std::uint32_t length;
+    std::uint32_t end;
+};
+
+} // unnamed namespace
+
+namespace templet {
+
+/**
+ * @brief The JsonTape struct holds JSON text and its parsed entries
+ */
+struct JsonTape {
+    std::string text;
+    std::vector<Entry> entries;
+};
+
+} // namespace templet
+
+namespace {
+
+const std::size_t MaxDepth = 512;
+
+/**
+ * @brief The JsonParser class parses JSON text into entries in one pass
+ */
+class JsonParser {
+private:
+    const std::string& _text;
+    std::vector<Entry>& _entries;
+    std::size_t _pos;
+    std::size_t _depth;
+
+    [[noreturn]] void fail(const char* message) const {
+        throw std::runtime_error("Invalid JSON at offset " + std::to_string(_pos) + ": " + message);
+    }
+
+    bool done() const {
+        return _pos == _text.size();
+    }
+
+    void skipSpace() {
+        while(!done() && (_text[_pos] == ' ' || _text[_pos] == '\n'
+                          || _text[_pos] == '\r' || _text[_pos] == '\t')) {
+            ++_pos;
+        }
+    }
+
+    std::size_t push(Kind kind, std::size_t begin, std::size_t length) {
+        _entries.push_back(Entry{kind, static_cast<std::uint32_t>(begin),
+                                 static_cast<std::uint32_t>(length),
+                                 static_cast<std::uint32_t>(_entries.size() + 1)});
+        return _entries.size() - 1;
+    }
+
+    bool isDigit() const {
+        return !done() && _text[_pos] >= '0' && _text[_pos] <= '9';
+    }
+
+    bool isHex(char c) const {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+    }
+
+    void literal(const char* word, Kind kind) {
+        const auto length = std::strlen(word);
+        if(_text.compare(_pos, length, word) != 0) {
+            fail("unexpected character");
+        }
+        push(kind, _pos, length);
+        _pos += length;
+    }
+
+    void number() {
+        const auto begin = _pos;
+        auto kind = KindInteger;
+        if(_text[_pos] == '-') {
+            ++_pos;
+        }
+        if(!isDigit()) {
+            fail("expected a digit");
+        }
+        if(_text[_pos] == '0') {
+            ++_pos;
+        }
+        else {
+            while(isDigit()) {
+                ++_pos;
+            }
+        }
+        if(!done() && _text[_pos] == '.') {
+            kind = KindFloat;
+            ++_pos;
+            if(!isDigit()) {
+                fail("expected a digit");
+            }
+            while(isDigit()) {
+                ++_pos;
+            }
+        }
+        if(!done() && (_text[_pos] == 'e' || _text[_pos] == 'E')) {
+            kind = KindFloat;
+            ++_pos;
+            if(!done() && (_text[_pos] == '+' || _text[_pos] == '-')) {
+                ++_pos;
+            }
+            if(!isDigit()) {
+                fail("expected a digit");
+            }
+            while(isDigit()) {
+                ++_pos;
+            }
+        }
+        push(kind, begin, _pos - begin);
+    }
+
+    void string() {
+        const auto begin = ++_pos;
+        auto kind = KindString;
+        while(!done() && _text[_pos] != '"') {
+            const auto c = static_cast<unsigned char>(_text[_pos]);
+            if(c < 0x20) {
+                fail("control character in string");
+            }
+            if(c == '\\') {
+                kind = KindEscapedString;
+                if(++_pos == _text.size()) {
+                    break;
+                }
+                switch(_text[_pos]) {
+                case '"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't':
+                    break;
+                case 'u':
+                    for(int i = 0; i < 4; ++i) {
+                        if(++_pos == _text.size() || !isHex(_text[_pos])) {
+                            fail("invalid unicode escape");
+                        }
+                    }
+                    break;
+                default:
+                    fail("invalid escape");
+                }
+            }
+            ++_pos;
+        }
+        if(done()) {
+            fail("unterminated string");
+        }
+        push(kind, begin, _pos - begin);
+        ++_pos;
+    }
+
+    void array() {
+        const auto index = push(KindArray, _pos, 0);
+        ++_pos;
+        std::uint32_t count = 0;
+        skipSpace();
+        if(!done() && _text[_pos] == ']') {
+            ++_pos;
+        }
+        else {
+            while(true) {
+                value();
+                ++count;
+                skipSpace();
+                if(done()) {
+                    fail("unterminated array");
+                }
+                if(_text[_pos++] == ']') {
+                    break;
+                }
+                if(_text[_pos - 1] != ',') {
+                    --_pos;
+                    fail("expected , or ]");
+                }
+            }
+        }
+        _entries[index].length = count;
+        _entries[index].end = static_cast<std::uint32_t>(_entries.size());
+    }
+
+    void object() {
+        const auto index = push(KindObject, _pos, 0);
+        ++_pos;
+        std::uint32_t count = 0;
+        skipSpace();
+        if(!done() && _text[_pos] == '}') {
+            ++_pos;
+        }
+        else {
+            while(true) {
+                skipSpace();
+                if(done() || _text[_pos] != '"') {
+                    fail("expected a key");
+                }
+                string();
+                skipSpace();
+                if(done() || _text[_pos] != ':') {
+                    fail("expected :");
+                }
+                ++_pos;
+                value();
+                ++count;
+                skipSpace();
+                if(done()) {
+                    fail("unterminated object");
+                }
+                if(_text[_pos++] == '}') {
+                    break;
+                }
+                if(_text[_pos - 1] != ',') {
+                    --_pos;
+                    fail("expected , or }");
+                }
+            }
+        }
+        _entries[index].length = count;
+        _entries[index].end = static_cast<std::uint32_t>(_entries.size());
+    }
+
+    void value() {
+        skipSpace();
+        if(done()) {
+            fail("expected a value");
+        }
+        switch(_text[_pos]) {
+        case '{':
+        case '[':
+            if(++_depth > MaxDepth) {
+                fail("nested too deeply");
+            }
+            if(_text[_pos] == '{') {
+                object();
+            }
+            else {
+                array();
+            }
+            --_depth;
+            break;
+        case '"':
+            string();
+            break;
+        case 't':
+            literal("true", KindTrue);
+            break;
+        case 'f':
+            literal("false", KindFalse);
+            break;
+        case 'n':
+            literal("null", KindNull);
+            break;
+        default:
+            number();
+        }
+    }
+
+public:
+    JsonParser(const std::string& text, std::vector<Entry>& entries)
+        : _text(text), _entries(entries), _pos(0), _depth(0) {}
+
+    void parse() {
+        if(_text.size() >= std::numeric_limits<std::uint32_t>::max()) {
+            throw std::runtime_error("JSON text is too large");
+        }
+        value();
+        skipSpace();
+        if(!done()) {
+            fail("unexpected text after value");
+        }
+    }
+};
+
+unsigned hex_value(const char* p) {
+    unsigned value = 0;
+    for(int i = 0; i < 4; ++i) {
+        const char c = p[i];
+        value = value * 16 + static_cast<unsigned>(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+    }
+    return value;
+}
+
+void append_utf8(std::string& out, unsigned code) {
+    if(code < 0x80) {
+        out += static_cast<char>(code);
+    }
+    else if(code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if(code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+/**
+ * @brief Decode the escapes of a string that has been validated by JsonParser
+ * @param p Start of string
+ * @param length Length of string
+ * @param out Decoded string
+ */
+void unescape(const char* p, std::size_t length, std::string& out) {
+    out.clear();
+    const char* end = p + length;
+    while(p != end) {
+        if(*p != '\\') {
+            out += *p++;
+            continue;
+        }
+        ++p;
+        switch(*p++) {
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'u': {
+            unsigned code = hex_value(p);
+            p += 4;
+            if(code >= 0xD800 && code < 0xDC00 && end - p >= 6 && p[0] == '\\' && p[1] == 'u') {
+                const unsigned low = hex_value(p + 2);
+                if(low >= 0xDC00 && low < 0xE000) {
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                    p += 6;
+                }
+            }
+            if(code >= 0xD800 && code < 0xE000) {
+                code = 0xFFFD;
+            }
+            append_utf8(out, code);
+            break;
+        }
+        default:
+            out += p[-1];
+        }
+    }
+}
+
+/**
+ * @brief The JsonNode class reads a value of a JSON document
+ *
+ * A node is a tape index. Values are written straight from the
+ * document text; getList and getMap build the nodes of the children
+ * on the first call, guarded by std::call_once, and keep them. Lookups
+ * by index or key go through them, so they don't walk the tape or
+ * allocate after the first one. A parsed document is read-only, so
+ * renders in different threads can share it.
+ */
+class JsonNode : public Data {
+private:
+    const JsonTape* _tape;
+    std::uint32_t _index;
+    mutable std::once_flag _listOnce;
+    mutable DataVector _list;
+    mutable std::once_flag _mapOnce;
+    mutable DataMap _map;
+
+    const Entry& entry() const {
+        return _tape->entries[_index];
+    }
+
+    const char* text() const {
+        return _tape->text.data() + entry().begin;
+    }
+
+    void check(Kind expected, const char* message) const {
+        const auto kind = entry().kind;
+        if(expected == KindString ? kind >= KindArray : kind != expected) {
+            throw std::runtime_error(message);
+        }
+    }
+
+    /**
+     * @brief Check whether a value is null or false, which are not set
+     */
+    bool isUnset(std::uint32_t index) const {
+        const auto kind = _tape->entries[index].kind;
+        return kind == KindNull || kind == KindFalse;
+    }
+
+public:
+    JsonNode(const JsonTape* tape, std::uint32_t index)
+        : _tape(tape), _index(index), _listOnce(), _list(), _mapOnce(), _map() {}
+
+    bool empty() const override {
+        switch(entry().kind) {
+        case KindNull:
+        case KindFalse:
+            return true;
+        case KindTrue:
+        case KindInteger:
+        case KindFloat:
+            return false;
+        default:
+            return entry().length == 0;
+        }
+    }
+
+    std::string getValue() const override {
+        check(KindString, "Data item is not of type value");
+        std::string value;
+        switch(entry().kind) {
+        case KindNull:
+        case KindFalse:
+            break;
+        case KindEscapedString:
+            unescape(text(), entry().length, value);
+            break;
+        default:
+            value.assign(text(), entry().length);
+        }
+        return value;
+    }
+
+    const DataVector& getList() const override {
+        check(KindArray, "Data item is not of type list");
+        std::call_once(_listOnce, [this]{
+            DataVector list;
+            list.reserve(entry().length);
+            for(auto index = _index + 1; index != entry().end; index = _tape->entries[index].end) {
+                list.push_back(std::make_shared<JsonNode>(_tape, index));
+            }
+            _list.swap(list);
+        });
+        return _list;
+    }
+
+    const DataMap& getMap() const override {
+        check(KindObject, "Data item is not of type map");
+        std::call_once(_mapOnce, [this]{
+            DataMap map;
+            for(auto index = _index + 1; index != entry().end; index = _tape->entries[index + 1].end) {
+                if(isUnset(index + 1)) {
+                    continue;
+                }
+                const JsonNode key(_tape, index);
+                map.emplace(key.getValue(), std::make_shared<JsonNode>(_tape, index + 1));
+            }
+            _map.swap(map);
+        });
+        return _map;
+    }
+
+    /**
+     * @brief Get an element, null and false elements are not set like members
+     */
+    const Data* getItem(std::size_t position, DataPtr& /*holder*/) const override {
+        const auto& list = getList();
+        if(position >= list.size()) {
+            return nullptr;
+        }
+        const auto& item = static_cast<const JsonNode&>(*list[position]);
+        return isUnset(item._index) ? nullptr : &item;
+    }
+
+    const Data* getItem(const std::string& key, DataPtr& /*holder*/) const override {
+        const auto& map = getMap();
+        const auto it = map.find(key);
+        return it == map.cend() ? nullptr : it->second.get();
+    }
+
+    std::unique_ptr<DataCursor> getCursor() const override;
+
+    void write(std::ostream& os) const override {
+        check(KindString, "Data item is not of type value");
+        switch(entry().kind) {
+        case KindNull:
+        case KindFalse:
+            break;
+        case KindEscapedString:
+            os << getValue();
+            break;
+        default:
+            os.write(text(), entry().length);
+        }
+    }
+
+    DataType type() const override {
+        switch(entry().kind) {
+        case KindInteger:
+            return DataType::Integer;
+        case KindFloat:
+            return DataType::Float;
+        case KindArray:
+            return DataType::List;
+        case KindObject:
+            return DataType::Mapper;
+        default:
+            return DataType::String;
+        }
+    }
+};
+
+/**
+ * @brief The JsonCursor class reads the elements of an array
+ *
+ * The node of each element is created in storage owned by the cursor
+ */
+class JsonCursor : public DataCursor {
+private:
+    const JsonTape* _tape;
+    std::uint32_t _pos;
+    std::uint32_t _end;
+    mylib::InPlace<JsonNode> _item;
+
+public:
+    JsonCursor(const JsonTape* tape, std::uint32_t index)
+        : _tape(tape), _pos(index + 1), _end(tape->entries[index].end), _item() {}
+
+    const Data* next() override {
+        if(_pos == _end) {
+            return nullptr;
+        }
+        const auto index = _pos;
+        _pos = _tape->entries[_pos].end;
+        return &_item.emplace(_tape, index);
+    }
+};
+
+std::unique_ptr<DataCursor> JsonNode::getCursor() const {
+    check(KindArray, "Data item is not of type list");
+    return mylib::make_unique<JsonCursor>(_tape, _index);
+}
+
+/**
+ * @brief The NdjsonCursor class reads the lines of NDJSON input
+ *
+ * Every line is parsed into the same tape, and the node of each line
+ * is created in storage owned by the cursor
+ */
+class NdjsonCursor : public DataCursor {
+private:
+    std::unique_ptr<std::istream> _in;
+    std::size_t _line;
+    JsonTape _tape;
+    mylib::InPlace<JsonNode> _row;
+
+public:
+    NdjsonCursor(std::unique_ptr<std::istream> in)
+        : _in(std::move(in)), _line(0), _tape(), _row() {}
+
+    const Data* next() override {
+        auto& text = _tape.text;
+        do {
+            if(!std::getline(*_in, text)) {
+                return nullptr;
+            }
+            ++_line;
+        } while(text.find_first_not_of(" \t\r") == std::string::npos);
+
+        // The previous row refers to the tape
+        _row.reset();
+        _tape.entries.clear();
+        try {
+            JsonParser(text, _tape.entries).parse();
+        }
+        catch(const std::runtime_error& ex) {
+            throw std::runtime_error("Line " + std::to_string(_line) + ": " + ex.what());
+        }
+        return &_row.emplace(&_tape, 0);
+    }
+};
+
+} // unnamed namespace
+
+JsonDocument::JsonDocument() : _tape(new JsonTape), _root() {
+
+}
+
+JsonDocument::~JsonDocument() = default;
+
+std::unique_ptr<JsonDocument> JsonDocument::parse(std::string text) {
+    std::unique_ptr<JsonDocument> document(new JsonDocument);
+    document->_tape->text = std::move(text);
+    JsonParser(document->_tape->text, document->_tape->entries).parse();
+    document->_root = std::make_shared<JsonNode>(document->_tape.get(), 0);
+    return document;
+}
+
+const Data& JsonDocument::root() const {
+    return *_root;
+}
+
+const DataMap& JsonDocument::values() const {
+    return _root->getMap();
+}
+
+DataPtr templet::make_ndjson_stream(std::function<std::unique_ptr<std::istream>()> open) {
+    return make_stream([open]{
+        return mylib::make_unique<NdjsonCursor>(open());
+    });
+}
+
+DataPtr templet::make_ndjson_stream(const std::string& path) {
+    return make_ndjson_stream([path]() -> std::unique_ptr<std::istream> {
+        std::unique_ptr<std::istream> in(new std::ifstream(path, std::ios::binary));
+        if(!*in) {
+            throw std::runtime_error("Unable to open file " + path);
+        }
+        return in;
+    });
+}
@@ -0,0 +1,126 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include "types.hpp"
+
+namespace templet {
+
+struct JsonTape;
+
+/**
+ * @brief The JsonDocument class renders from JSON text
+ *
+ * The text is parsed once into an index of the values. The values
+ * are views that read from the original text when a template reads
+ * them, strings aren't copied unless they contain escapes.
+ *
+ * Objects are maps, arrays are lists, strings are values and numbers
+ * are integers or floats. true is the value "true". Members and
+ * array elements that are null or false are treated as not set, so
+ * that IF statements see them as false. Loops still visit such
+ * elements, as empty values.
+ *
+ * Example usage:
+ *
+ * auto json = templet::JsonDocument::parse(R"({"users": ["John", "Jane"]})");\n
+ * templet::parse("{% for users as user %}{$ user }{% endfor %}", json->values(), std::cout);
+ *
+ * The document must outlive the renders that use its values.
+ */
+class JsonDocument {
+private:
+    std::unique_ptr<JsonTape> _tape;
+    DataPtr _root;
+
+    JsonDocument();
+
+public:
+    JsonDocument(const JsonDocument&) = delete;
+    JsonDocument& operator=(const JsonDocument&) = delete;
+
+    ~JsonDocument();
+
+    /**
+     * @brief Parse JSON text
+     * @param text JSON text
+     * @exception std::runtime_error if the text is not valid JSON
+     * @return Parsed document
+     */
+    static std::unique_ptr<JsonDocument> parse(std::string text);
+
+    /**
+     * @brief Get the top-level value
+     * @return Top-level value
+     */
+    const types::Data& root() const;
+
+    /**
+     * @brief Get the members of the top-level object for rendering
+     * @exception std::runtime_error if the top-level value is not an object
+     * @return Map of members
+     */
+    const DataMap& values() const;
+};
+
+/**
+ * @brief Stream the rows of NDJSON input
+ *
+ * Every non-blank line is a JSON value, usually an object. Lines are
+ * read and parsed one at a time for each traversal, and the parsed
+ * entries and the view of the row are reused for every line, so
+ * memory use doesn't grow with the input.
+ *
+ * Example usage:
+ *
+ * data["rows"] = templet::make_ndjson_stream("export.ndjson");\n
+ * templet::Templet tpl("{% for rows as row %}{$ row.name },{$ row.email }\n{% endfor %}");\n
+ * tpl.render(data, std::cout);
+ *
+ * @param open Callback that opens the input for each traversal
+ * @exception std::runtime_error while rendering, if a line is not valid JSON
+ * @return Stream wrapped in DataPtr
+ */
+types::DataPtr make_ndjson_stream(std::function<std::unique_ptr<std::istream>()> open);
+
+/**
+ * @brief Stream the rows of an NDJSON file
+ * @param path Path to file
+ * @exception std::runtime_error while rendering, if the file can't be opened or
+ * a line is not valid JSON
+ * @return Stream wrapped in DataPtr
+ */
+types::DataPtr make_ndjson_stream(const std::string& path);
+
+} // namespace templet
+
+#endif // JSON_HPP
@@ -0,0 +1,106 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "literal.hpp"
+#include "nodes.hpp"
+
+using namespace templet;
+using namespace templet::nodes;
+using templet::literal::Token;
+using templet::literal::TokenKind;
+
+namespace {
+
+/**
+ * @brief Point to a string literal without owning it
+ */
+std::shared_ptr<const char> unowned(const char* text) {
+    return std::shared_ptr<const char>(std::shared_ptr<const char>(), text);
+}
+
+/**
+ * @brief Create nodes until the end of the tokens or the first endif/endfor
+ *
+ * Mirrors \link templet::tokenize \endlink: the children of a statement
+ * are the nodes that follow it up to the next closing tag, and an elif
+ * or else takes the rest of its if chain.
+ */
+std::vector<std::shared_ptr<Node>> build_block(const char* text, const Token* tokens,
+                                               std::size_t size, std::size_t& pos, const bool chain) {
+    std::vector<std::shared_ptr<Node>> nodes;
+    while(pos < size) {
+        const Token& token = tokens[pos++];
+        const std::string name(text + token.name, token.nameEnd - token.name);
+        std::shared_ptr<Node> node;
+        switch(token.kind) {
+        case TokenKind::Text:
+            nodes.push_back(std::make_shared<Text>(unowned(text + token.begin), token.end - token.begin));
+            continue;
+        case TokenKind::Escaped:
+            // The { is two characters before the text
+            nodes.push_back(std::make_shared<Text>(unowned(text + token.begin - 2), 1));
+            nodes.push_back(std::make_shared<Text>(unowned(text + token.begin), token.end - token.begin));
+            continue;
+        case TokenKind::Value:
+            nodes.push_back(std::make_shared<Value>(name));
+            continue;
+        case TokenKind::End:
+            return nodes;
+        case TokenKind::If:
+            node = std::make_shared<IfValue>(name);
+            break;
+        case TokenKind::Elif:
+            node = std::make_shared<ElifValue>(name);
+            break;
+        case TokenKind::Else:
+            node = std::make_shared<ElseValue>();
+            break;
+        case TokenKind::For:
+            node = std::make_shared<ForValue>(name, std::string(text + token.alias, token.aliasEnd - token.alias));
+            break;
+        }
+        const bool branch = token.kind == TokenKind::Elif || token.kind == TokenKind::Else;
+        node->setChildren(build_block(text, tokens, size, pos, branch || token.kind == TokenKind::If));
+        nodes.push_back(std::move(node));
+        if(chain && branch) {
+            // The branch ended the chain
+            break;
+        }
+    }
+    return nodes;
+}
+
+} // namespace
+
+std::vector<std::shared_ptr<Node>> templet::literal::build(const char* text, const Token* tokens, std::size_t size) {
+    std::size_t pos = 0;
+    return build_block(text, tokens, size, pos, false);
+}
@@ -0,0 +1,422 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef LITERAL_HPP
+#define LITERAL_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "nodes.hpp"
+#include "templet.hpp"
+
+namespace templet {
+namespace literal {
+
+/**
+ * The functions in this namespace tokenize template literals at compile
+ * time with the same rules as \link templet::tokenize \endlink. They're
+ * written in the recursive C++11 constexpr style. Searches split their
+ * range in halves so that the recursion depth grows with the number of
+ * tags, not the number of characters. The compiler's constexpr depth
+ * limit (512 by default) caps a literal template at a few hundred text
+ * blocks and tags.
+ */
+
+/**
+ * @brief Errors that \link templet::tokenize \endlink would throw
+ */
+enum class Error {
+    None,
+    NotEnclosed,
+    IfPrefix,
+    ElifPrefix,
+    UnknownTag,
+    VariableName,
+    IfName,
+    ForSyntax,
+    ForName,
+    ForAlias
+};
+
+/**
+ * @brief Kinds of tokens
+ */
+enum class TokenKind {
+    Text,       ///< Text from begin to end
+    Escaped,    ///< An ignored tag, "{" followed by the text from begin to end
+    Value,      ///< A variable tag
+    If,         ///< An if tag
+    Elif,       ///< An elif tag
+    Else,       ///< An else tag
+    For,        ///< A for tag
+    End         ///< An endif or endfor tag
+};
+
+/**
+ * @brief The Token struct is a text block or a tag in a literal template
+ *
+ * Positions are offsets into the literal.
+ */
+struct Token {
+    TokenKind kind;
+    std::size_t begin;
+    std::size_t end;
+    std::size_t name;
+    std::size_t nameEnd;
+    std::size_t alias;
+    std::size_t aliasEnd;
+};
+
+constexpr bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+constexpr bool is_name_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+            (c >= '0' && c <= '9') || c == '_' || c == '-';
+}
+
+constexpr bool is_expression_char(char c) {
+    return is_name_char(c) || c == '[' || c == ']' || c == '.';
+}
+
+constexpr std::size_t find_right(const char* s, char c, std::size_t left, std::size_t mid, std::size_t hi);
+
+/**
+ * @brief Find a character
+ * @return Position of the first c in [lo, hi), or hi if not found
+ */
+constexpr std::size_t find(const char* s, char c, std::size_t lo, std::size_t hi) {
+    return lo >= hi ? hi
+         : hi - lo == 1 ? (s[lo] == c ? lo : hi)
+         : find_right(s, c, find(s, c, lo, lo + (hi - lo) / 2), lo + (hi - lo) / 2, hi);
+}
+
+constexpr std::size_t find_right(const char* s, char c, std::size_t left, std::size_t mid, std::size_t hi) {
+    return left != mid ? left : find(s, c, mid, hi);
+}
+
+/**
+ * @brief Check that all characters in [lo, hi) are valid name characters
+ */
+constexpr bool all_name(const char* s, std::size_t lo, std::size_t hi) {
+    return lo >= hi ? true
+         : hi - lo == 1 ? is_name_char(s[lo])
+         : all_name(s, lo, lo + (hi - lo) / 2) && all_name(s, lo + (hi - lo) / 2, hi);
+}
+
+/**
+ * @brief Check that all characters in [lo, hi) are valid name expression characters
+ */
+constexpr bool all_expression(const char* s, std::size_t lo, std::size_t hi) {
+    return lo >= hi ? true
+         : hi - lo == 1 ? is_expression_char(s[lo])
+         : all_expression(s, lo, lo + (hi - lo) / 2) && all_expression(s, lo + (hi - lo) / 2, hi);
+}
+
+/**
+ * @brief Skip leading whitespace
+ * @return Position of the first non-whitespace character in [lo, hi), or hi
+ */
+constexpr std::size_t ltrim(const char* s, std::size_t lo, std::size_t hi) {
+    return lo < hi && is_space(s[lo]) ? ltrim(s, lo + 1, hi) : lo;
+}
+
+/**
+ * @brief Skip trailing whitespace
+ * @return End of [lo, hi) without trailing whitespace
+ */
+constexpr std::size_t rtrim(const char* s, std::size_t lo, std::size_t hi) {
+    return lo < hi && is_space(s[hi - 1]) ? rtrim(s, lo, hi - 1) : hi;
+}
+
+constexpr bool starts_with(const char* s, std::size_t lo, std::size_t hi, const char* prefix) {
+    return *prefix == '\0' ? true
+         : lo < hi && s[lo] == *prefix && starts_with(s, lo + 1, hi, prefix + 1);
+}
+
+constexpr bool equals(const char* s, std::size_t lo, std::size_t hi, const char* word) {
+    return lo == hi ? *word == '\0' : starts_with(s, lo, hi, word) && equals(s, lo + 1, hi, word + 1);
+}
+
+/**
+ * @brief Find the end of the token that starts at i
+ */
+constexpr std::size_t token_end(const char* s, std::size_t n, std::size_t i) {
+    return s[i] != '{' ? find(s, '{', i, n)
+         : find(s, '}', i, n) == n ? n
+         : find(s, '}', i, n) + 1;
+}
+
+/**
+ * @brief Check if the token [i, e) is a closed tag
+ */
+constexpr bool is_tag(const char* s, std::size_t i, std::size_t e) {
+    return s[i] == '{' && s[e - 1] == '}';
+}
+
+/**
+ * @brief Get the kind of the statement that starts at a, or Text if unknown
+ */
+constexpr TokenKind statement_kind(const char* s, std::size_t a, std::size_t e) {
+    return starts_with(s, a, e, "endif") || starts_with(s, a, e, "endfor") ? TokenKind::End
+         : starts_with(s, a, e, "if") ? TokenKind::If
+         : starts_with(s, a, e, "elif") ? TokenKind::Elif
+         : starts_with(s, a, e, "else") ? TokenKind::Else
+         : starts_with(s, a, e, "for") ? TokenKind::For
+         : TokenKind::Text;
+}
+
+/**
+ * @brief Get the end of the expression that starts at a, without the closing % and whitespace
+ */
+constexpr std::size_t expression_end(const char* s, std::size_t i, std::size_t e, std::size_t a) {
+    return rtrim(s, a, find(s, '%', i + 2, e));
+}
+
+/**
+ * @brief Get the position after the n-th space in [lo, hi)
+ */
+constexpr std::size_t after_space(const char* s, std::size_t lo, std::size_t hi, int n) {
+    return n == 0 ? lo : after_space(s, find(s, ' ', lo, hi) + 1, hi, n - 1);
+}
+
+constexpr Token make_token(TokenKind kind, std::size_t begin, std::size_t end,
+                           std::size_t name = 0, std::size_t nameEnd = 0,
+                           std::size_t alias = 0, std::size_t aliasEnd = 0) {
+    return Token{kind, begin, end, name, nameEnd, alias, aliasEnd};
+}
+
+/**
+ * @brief Get the token of the {% %} tag [i, e)
+ * @param a Start of the statement
+ * @param x End of the expression
+ */
+constexpr Token statement_token(const char* s, std::size_t i, std::size_t e,
+                                std::size_t a, std::size_t x, TokenKind kind) {
+    return kind == TokenKind::If ? make_token(kind, i, e, ltrim(s, a + 3, x), x)
+         : kind == TokenKind::Elif ? make_token(kind, i, e, ltrim(s, a + 5, x), x)
+         : kind == TokenKind::For ? make_token(kind, i, e, after_space(s, a, x, 1), after_space(s, a, x, 2) - 1,
+                                               after_space(s, a, x, 3), x)
+         : make_token(kind, i, e);
+}
+
+constexpr Token value_token(const char* s, std::size_t i, std::size_t e, std::size_t a) {
+    return make_token(TokenKind::Value, i, e, a, rtrim(s, a, e - 1));
+}
+
+constexpr Token tag_token(const char* s, std::size_t i, std::size_t e) {
+    return s[i + 1] == '\\' ? make_token(TokenKind::Escaped, i + 2, e)
+         : s[i + 1] == '$' ? value_token(s, i, e, ltrim(s, i + 2, e - 1))
+         : s[i + 1] == '%' ? statement_token(s, i, e, ltrim(s, i + 2, e),
+                                             expression_end(s, i, e, ltrim(s, i + 2, e)),
+                                             statement_kind(s, ltrim(s, i + 2, e), e))
+         : make_token(TokenKind::Text, i, e);
+}
+
+/**
+ * @brief Get the token [i, e)
+ */
+constexpr Token token(const char* s, std::size_t i, std::size_t e) {
+    return is_tag(s, i, e) ? tag_token(s, i, e) : make_token(TokenKind::Text, i, e);
+}
+
+/**
+ * @brief Check the fields of the for expression [a, x) split at spaces p1, p2 and p3
+ */
+constexpr Error for_fields(const char* s, std::size_t a, std::size_t x,
+                           std::size_t p1, std::size_t p2, std::size_t p3) {
+    return p3 >= x || find(s, ' ', p3 + 1, x) != x ? Error::ForSyntax
+         : !equals(s, a, p1, "for") || !equals(s, p2 + 1, p3, "as") ? Error::ForSyntax
+         : !all_expression(s, p1 + 1, p2) ? Error::ForName
+         : !all_name(s, p3 + 1, x) ? Error::ForAlias
+         : Error::None;
+}
+
+constexpr Error for_second_space(const char* s, std::size_t a, std::size_t x, std::size_t p1, std::size_t p2) {
+    return p2 >= x ? Error::ForSyntax : for_fields(s, a, x, p1, p2, find(s, ' ', p2 + 1, x));
+}
+
+constexpr Error for_first_space(const char* s, std::size_t a, std::size_t x, std::size_t p1) {
+    return p1 >= x ? Error::ForSyntax : for_second_space(s, a, x, p1, find(s, ' ', p1 + 1, x));
+}
+
+/**
+ * @brief Check the if or elif expression [a, x)
+ */
+constexpr Error if_error(const char* s, std::size_t a, std::size_t x,
+                         const char* prefix, std::size_t skip, Error prefixError) {
+    return !starts_with(s, a, x, prefix) ? prefixError
+         : !all_expression(s, ltrim(s, a + skip, x), x) ? Error::IfName
+         : Error::None;
+}
+
+/**
+ * @brief Get the error of the {% %} tag [i, e)
+ * @param a Start of the statement
+ * @param x End of the expression
+ */
+constexpr Error statement_error(const char* s, std::size_t e, std::size_t a, std::size_t x, TokenKind kind) {
+    return kind == TokenKind::Text ? Error::UnknownTag
+         : kind == TokenKind::End || kind == TokenKind::Else ? Error::None
+         : s[e - 2] != '%' ? Error::NotEnclosed
+         : kind == TokenKind::If ? if_error(s, a, x, "if ", 3, Error::IfPrefix)
+         : kind == TokenKind::Elif ? if_error(s, a, x, "elif ", 5, Error::ElifPrefix)
+         : for_first_space(s, a, x, find(s, ' ', a, x));
+}
+
+constexpr Error percent_error(const char* s, std::size_t i, std::size_t e, std::size_t a) {
+    return statement_error(s, e, a, expression_end(s, i, e, a), statement_kind(s, a, e));
+}
+
+constexpr Error value_error(const char* s, std::size_t e, std::size_t a) {
+    return all_expression(s, a, rtrim(s, a, e - 1)) ? Error::None : Error::VariableName;
+}
+
+/**
+ * @brief Get the error of the token [i, e)
+ */
+constexpr Error token_error(const char* s, std::size_t i, std::size_t e) {
+    return !is_tag(s, i, e) ? Error::None
+         : s[i + 1] == '$' ? value_error(s, e, ltrim(s, i + 2, e - 1))
+         : s[i + 1] == '%' ? percent_error(s, i, e, ltrim(s, i + 2, e))
+         : Error::None;
+}
+
+/**
+ * @brief Get the first error from position i
+ */
+constexpr Error error(const char* s, std::size_t n, std::size_t i = 0) {
+    return i >= n ? Error::None
+         : token_error(s, i, token_end(s, n, i)) != Error::None ? token_error(s, i, token_end(s, n, i))
+         : error(s, n, token_end(s, n, i));
+}
+
+template <std::size_t... I>
+struct Indices {};
+
+/**
+ * @brief The Starts class collects the start positions of the tokens of a literal template
+ *
+ * Literal is a class with static constexpr functions data() and
+ * size() that return the template text and its length.
+ */
+template <class Literal, bool Done, std::size_t I, std::size_t... S>
+struct Starts;
+
+template <class Literal, std::size_t I, std::size_t... S>
+struct Starts<Literal, false, I, S...>
+    : Starts<Literal, token_end(Literal::data(), Literal::size(), I) >= Literal::size(),
+             token_end(Literal::data(), Literal::size(), I), S..., I> {};
+
+template <class Literal, std::size_t I, std::size_t... S>
+struct Starts<Literal, true, I, S...> {
+    using type = Indices<S...>;
+};
+
+/**
+ * @brief The Table class holds the tokens of a literal template
+ */
+template <class Literal, class = typename Starts<Literal, Literal::size() == 0, 0>::type>
+struct Table;
+
+template <class Literal, std::size_t... S>
+struct Table<Literal, Indices<S...>> {
+    // One extra token so that the array is never empty
+    static constexpr Token tokens[sizeof...(S) + 1] = {
+        token(Literal::data(), S, token_end(Literal::data(), Literal::size(), S))..., make_token(TokenKind::End, 0, 0)
+    };
+    static constexpr std::size_t size = sizeof...(S);
+};
+
+template <class Literal, std::size_t... S>
+constexpr Token Table<Literal, Indices<S...>>::tokens[sizeof...(S) + 1];
+
+/**
+ * @brief Create nodes from tokens
+ * @param text Template text
+ * @param tokens Tokens of the text
+ * @param size Number of tokens
+ * @return Nodes like \link templet::tokenize \endlink returns, with text nodes that refer to the text
+ */
+std::vector<std::shared_ptr<nodes::Node>> build(const char* text, const Token* tokens, std::size_t size);
+
+/**
+ * @brief Create a Templet object from the tokens of a literal template
+ * @return Templet object with its nodes created
+ */
+template <class Literal>
+Templet compile() {
+    // One copy of the text for all Templet objects of the literal
+    static const std::string text(Literal::data(), Literal::size());
+    return Templet(std::shared_ptr<const std::string>(std::shared_ptr<const std::string>(), &text),
+                   build(Literal::data(), Table<Literal>::tokens, Table<Literal>::size));
+}
+
+} // namespace literal
+} // namespace templet
+
+/**
+ * @brief Create a Templet object from a string literal that's tokenized at compile time
+ *
+ * Syntax errors that \link templet::tokenize \endlink would throw as
+ * templet::exception::InvalidTagError or ExpressionSyntaxError are
+ * compile errors with the same message.
+ *
+ * Example usage:
+ *
+ * static const auto tpl = TEMPLET_LITERAL("Hello, {$first_name} {$last_name}!");
+ */
+#define TEMPLET_LITERAL(text) \
+    ([]() -> templet::Templet { \
+        struct Literal { \
+            static constexpr const char* data() { return text; } \
+            static constexpr std::size_t size() { return sizeof(text) - 1; } \
+        }; \
+        static_assert(templet::literal::error(text, sizeof(text) - 1) != templet::literal::Error::NotEnclosed, \
+                      "Tag must be enclosed with {% and %}"); \
+        static_assert(templet::literal::error(text, sizeof(text) - 1) != templet::literal::Error::IfPrefix, \
+                      "Tag must be prefixed with 'if '"); \
+        static_assert(templet::literal::error(text, sizeof(text) - 1) != templet::literal::Error::ElifPrefix, \
+                      "Tag must be prefixed with 'elif '"); \
+        static_assert(templet::literal::error(text, sizeof(text) - 1) != templet::literal::Error::UnknownTag, \
+                      "Unknown tag type: No parser available for this tag"); \
+        static_assert(templet::literal::error(text, sizeof(text) - 1) != templet::literal::Error::VariableName, \
+                      "Variable tag name contains invalid characters"); \
+        static_assert(templet::literal::error(text, sizeof(text) - 1) != templet::literal::Error::IfName, \
+                      "If expression tag name contains invalid characters"); \
+        static_assert(templet::literal::error(text, sizeof(text) - 1) != templet::literal::Error::ForSyntax, \
+                      "Unrecognized for expression syntax"); \
+        static_assert(templet::literal::error(text, sizeof(text) - 1) != templet::literal::Error::ForName, \
+                      "For expression first tag name contains invalid characters"); \
+        static_assert(templet::literal::error(text, sizeof(text) - 1) != templet::literal::Error::ForAlias, \
+                      "For expression second tag name contains invalid characters"); \
+        return templet::literal::compile<Literal>(); \
+    }())
+
+#endif // LITERAL_HPP
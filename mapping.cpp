@@ -0,0 +1,112 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include "mapping.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TEMPLET_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace templet::helpers;
+
+MappedFile::MappedFile() : _buffer(), _data(nullptr), _size(0), _mapping(nullptr) {
+
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+#ifdef TEMPLET_MMAP
+    if(_mapping) {
+        ::munmap(_mapping, _size);
+    }
+#endif
+    _mapping = nullptr;
+    _buffer.clear();
+    _data = nullptr;
+    _size = 0;
+}
+
+void MappedFile::open(const std::string& path) {
+    close();
+#ifdef TEMPLET_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd == -1) {
+        throw std::runtime_error("Unable to open file " + path);
+    }
+    struct stat info;
+    if(::fstat(fd, &info) == -1) {
+        ::close(fd);
+        throw std::runtime_error("Unable to read file " + path);
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    if(size > 0) {
+        void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if(mapping == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("Unable to map file " + path);
+        }
+        _mapping = mapping;
+        _data = static_cast<const char*>(mapping);
+        _size = size;
+    }
+    ::close(fd);
+#else
+    std::ifstream file {path, std::ios::binary};
+    if(!file) {
+        throw std::runtime_error("Unable to open file " + path);
+    }
+    _buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    _data = _buffer.data();
+    _size = _buffer.size();
+#endif
+}
+
+void MappedFile::assign(std::string bytes) {
+    close();
+    _buffer = std::move(bytes);
+    _data = _buffer.data();
+    _size = _buffer.size();
+}
+
+const char* MappedFile::data() const {
+    return _data;
+}
+
+std::size_t MappedFile::size() const {
+    return _size;
+}
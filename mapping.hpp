@@ -0,0 +1,95 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef MAPPING_HPP
+#define MAPPING_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace templet {
+namespace helpers {
+
+/**
+ * @brief The MappedFile class holds the contents of a file in memory
+ *
+ * Files are mapped read-only into memory where mmap is available, so
+ * processes that load the same file share its pages. Elsewhere the
+ * file is read into a buffer.
+ */
+class MappedFile {
+private:
+    std::string _buffer;
+    const char* _data;
+    std::size_t _size;
+    void* _mapping;
+
+    /**
+     * @brief Release the current contents
+     */
+    void close();
+
+public:
+    /**
+     * @brief Construct an empty MappedFile
+     */
+    MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    /**
+     * @brief Map a file
+     * @param path Path to file
+     * @exception std::runtime_error if the file can't be opened or mapped
+     */
+    void open(const std::string& path);
+
+    /**
+     * @brief Use bytes in memory instead of a file
+     * @param bytes Contents
+     */
+    void assign(std::string bytes);
+
+    /**
+     * @brief Get the contents
+     * @return Pointer to the first byte, or nullptr if empty
+     */
+    const char* data() const;
+
+    /**
+     * @brief Get the size of the contents
+     * @return Size in bytes
+     */
+    std::size_t size() const;
+};
+
+} // namespace helpers
+} // namespace templet
+
+#endif // MAPPING_HPP
@@ -27,11 +27,13 @@ THE SOFTWARE.
 #include <algorithm>
 #include <cstddef>
 #include <functional>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <utility>
 #include "nodes.hpp"
+#include "segments.hpp"
 #include "split.hpp"
 #include "strutils.hpp"
 #include "trim.hpp"
@@ -77,7 +79,12 @@ bool isValidNameExpression(const std::string& name) {
  */
 bool parse_number(const std::string& text, int& result) {
     std::istringstream parser {text};
-    return parser >> result >> std::ws && parser.peek() == EOF;
+    if(!(parser >> result)) {
+        return false;
+    }
+    // Skipping trailing whitespace at the end sets failbit
+    parser >> std::ws;
+    return parser.eof();
 }
 
 /**
@@ -107,21 +114,217 @@ int parse_array_index(std::string in) {
 }
 
 /**
- * @brief Parse a full tag name
+ * @brief A helper function for \link Path::resolve \endlink that writes a string or a number
+ * @param os Output stream
+ * @param name Tag name
+ * @param res Parsed tag value
+ * @param stable False if the value is destroyed before the output is used, see \link Scope::stable \endlink
+ * @exception templet::exception::InvalidTagError if result is not a string or a number
+ */
+void write_tag_value(std::ostream& os, const std::string& name, const templet::types::Data* res, bool stable) {
+    if(!res) {
+            throw templet::exception::MissingTagError("Tag name not found: " + name);
+    }
+    else if(res->type() != templet::types::DataType::String &&
+            res->type() != templet::types::DataType::Integer &&
+            res->type() != templet::types::DataType::Float) {
+        throw templet::exception::InvalidTagError("Invalid tag name: Name must reference a string or a number");
+    }
+
+    const auto segments = stable ? nullptr : templet::segment_stream(os);
+    if(!segments || segments->copying()) {
+        res->write(os);
+        return;
+    }
+    // The segments must not refer to a value that is destroyed
+    // before they're written
+    segments->setCopying(true);
+    try {
+        res->write(os);
+    }
+    catch(...) {
+        segments->setCopying(false);
+        throw;
+    }
+    segments->setCopying(false);
+}
+
+/**
+ * @brief A helper function for \link Path::resolve \endlink that evaluates into a list cursor
+ * @param name Tag name
+ * @param res Parsed tag value
+ * @exception templet::exception::InvalidTagError if result is not a list or a stream
+ * @return Cursor to the elements of the parsed result
+ */
+std::unique_ptr<templet::types::DataCursor> parse_tag_cursor(const std::string& name,
+                                                            const templet::types::Data* res) {
+    if(!res) {
+            throw templet::exception::MissingTagError("Tag name not found: " + name);
+    }
+    else if(res->type() != templet::types::DataType::List &&
+            res->type() != templet::types::DataType::Stream) {
+        throw templet::exception::InvalidTagError("Invalid tag name: Name must reference a list");
+    }
+
+    return res->getCursor();
+}
+
+/**
+ * @brief Return the top-level name of a tag name
  *
- * Parses a full tag name, e.g.: config.servers[1].users[6].username
+ * Given a name like config.servers[1].ip, returns config
  *
- * @param name String to parse
- * @param kv Map of values to reference
- * @exception templet::exception::MissingTagError If tag is not found in kv
- * @exception templet::exception::InvalidTagError
- * @return DataPtr to the parsed tag value
+ * @param name Tag name
+ * @return Top-level name
  */
-templet::types::DataPtr parse_tag(std::string name, const DataMap& kv) {
-    // mapRef holds a reference to the current map level in dot notated tags
-    auto mapRef = std::cref(kv);
-    // lastItem holds a pointer to the last evaluated value in the tag
-    templet::types::DataPtr lastItem;
+std::string root_name(const std::string& name) {
+    return name.substr(0, name.find_first_of(".["));
+}
+
+/**
+ * @brief Collect the paths of nodes and their child nodes by name
+ * @param nodes Nodes to collect from
+ * @param paths Paths by name
+ */
+void collect_paths(const std::vector<std::shared_ptr<Node>>& nodes, std::map<std::string, std::vector<Path*>>& paths) {
+    for(const auto& node : nodes) {
+        if(const auto path = node->path()) {
+            paths[path->name()].push_back(path);
+        }
+        collect_paths(node->children(), paths);
+    }
+}
+
+/**
+ * @brief Replace a value that is computed on demand with its computed value
+ *
+ * Values created during the lookup are computed every time, because
+ * their address can be reused once they're destroyed.
+ *
+ * @param scope Scope that binds the top-level name of the path
+ * @param value Value to compute
+ * @param holder Owner of the value if it was created, moved to keep
+ * @param keep Owners of created values
+ * @param stable If not null, set to false if the value was created or computed
+ * @return Computed value, or value if it isn't computed on demand
+ */
+const templet::types::Data* compute_value(const Scope& scope, const templet::types::Data* value,
+                                          templet::types::DataPtr& holder,
+                                          std::vector<templet::types::DataPtr>& keep, bool* stable) {
+    if(!holder) {
+        const auto computed = scope.computed(value);
+        if(stable && computed != value) {
+            *stable = false;
+        }
+        return computed;
+    }
+    if(stable) {
+        *stable = false;
+    }
+    keep.push_back(std::move(holder));
+    if(auto data = value->compute()) {
+        keep.push_back(std::move(data));
+        return keep.back().get();
+    }
+    return value;
+}
+
+} // unnamed namespace
+
+Scope::Scope(const DataMap& values)
+    : _values(&values), _parent(nullptr), _name(nullptr), _value(nullptr), _stable(true), _inline(), _memos(0),
+      _memo(), _keep(), _computed() {
+
+}
+
+Scope::Scope(const Scope& parent, const std::string& name, const templet::types::Data* value, bool stable)
+    : _values(nullptr), _parent(&parent), _name(&name), _value(value), _stable(stable), _inline(), _memos(0),
+      _memo(), _keep(), _computed() {
+
+}
+
+const templet::types::Data* Scope::find(const std::string& name) const {
+    const Scope* scope = this;
+    while(scope->_parent != nullptr) {
+        if(*scope->_name == name) {
+            return scope->_value;
+        }
+        scope = scope->_parent;
+    }
+
+    const auto it = scope->_values->find(name);
+    if(it == scope->_values->cend()) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+const Scope& Scope::owner(const std::string& name) const {
+    const Scope* scope = this;
+    while(scope->_parent != nullptr) {
+        if(*scope->_name == name) {
+            return *scope;
+        }
+        scope = scope->_parent;
+    }
+    return *scope;
+}
+
+bool Scope::stable() const {
+    return _stable;
+}
+
+bool Scope::recall(int slot, const templet::types::Data*& value, bool& stable) const {
+    for(std::size_t i = 0; i < _memos && i < InlineMemos; ++i) {
+        if(_inline[i].slot == slot) {
+            value = _inline[i].value;
+            stable = _inline[i].stable;
+            return true;
+        }
+    }
+    for(const auto& memo : _memo) {
+        if(memo.slot == slot) {
+            value = memo.value;
+            stable = memo.stable;
+            return true;
+        }
+    }
+    return false;
+}
+
+void Scope::remember(int slot, const templet::types::Data* value, bool stable,
+                     std::vector<templet::types::DataPtr>& keep) const {
+    if(_memos < InlineMemos) {
+        _inline[_memos] = Memo{slot, value, stable};
+    }
+    else {
+        _memo.push_back(Memo{slot, value, stable});
+    }
+    ++_memos;
+    for(auto& owner : keep) {
+        _keep.push_back(std::move(owner));
+    }
+    keep.clear();
+}
+
+const templet::types::Data* Scope::computed(const templet::types::Data* value) const {
+    for(const auto& entry : _computed) {
+        if(entry.first == value) {
+            return entry.second.get();
+        }
+    }
+    auto data = value->compute();
+    if(!data) {
+        return value;
+    }
+    _computed.emplace_back(value, std::move(data));
+    return _computed.back().second.get();
+}
+
+Path::Path(std::string name)
+    : _name(name), _steps(), _slot(-1) {
+    // Split the name the same way it's resolved, so that errors
+    // are found in the same order
     while(!name.empty()) {
         const auto pos = name.find('.');
         // Parse the first found tag name which may contain [n]...[n]
@@ -133,115 +336,164 @@ templet::types::DataPtr parse_tag(std::string name, const DataMap& kv) {
             name.erase(0, pos + 1);
         }
         const auto arrPos = tag.find('[');
-        // tagName contains the name before list indexing [n]...
-        const auto tagName = tag.substr(0, arrPos);
-        if(tagName.empty()) {
+        Step step {tag.substr(0, arrPos), "", arrPos != std::string::npos, {}};
+        if(step.name.empty()) {
             // This is true when e.g.:
             // {$ config.[1] } {$ .username }
-            throw templet::exception::InvalidTagError("Tags must have a name: " + tag);
+            step.error = "Tags must have a name: " + tag;
         }
-        else if(!isValidName(tagName)) {
-            throw templet::exception::InvalidTagError("Invalid syntax: " + tag);
+        else if(!isValidName(step.name)) {
+            step.error = "Invalid syntax: " + tag;
+        }
+        else if(step.indexed) {
+            auto arr = tag.substr(arrPos);
+            while(!arr.empty()) {
+                Index index {0, ""};
+                const auto arrEndPos = arr.find(']');
+                try {
+                    index.value = parse_array_index(arr.substr(0, arrEndPos + 1));
+                    arr.erase(0, arrEndPos + 1);
+                    if(!arr.empty() && arr[0] != '[') {
+                        // Valid e.g. for groups[0]users[1]
+                        index.error = "Invalid syntax: " + tag;
+                    }
+                }
+                catch(const templet::exception::InvalidTagError& ex) {
+                    index.error = ex.what();
+                }
+                step.indexes.push_back(index);
+                if(!index.error.empty()) {
+                    break;
+                }
+            }
         }
-        const auto& map = mapRef.get();
-        if(!map.count(tagName)) {
-            //throw templet::exception::MissingTagError("Tag name not found: " + tagName);
-            lastItem.reset();
+        const bool valid = step.error.empty();
+        _steps.push_back(std::move(step));
+        if(!valid) {
             break;
         }
-        lastItem = map.at(tagName);
-        // Parse the array index syntax
-        if(arrPos != std::string::npos) {
+    }
+}
+
+const std::string& Path::name() const {
+    return _name;
+}
+
+const std::string& Path::root() const {
+    static const std::string none;
+    return _steps.empty() ? none : _steps.front().name;
+}
+
+void Path::setSlot(int slot) {
+    _slot = slot;
+}
+
+int Path::slot() const {
+    return _slot;
+}
+
+const templet::types::Data* Path::resolve(const Scope& scope, std::vector<templet::types::DataPtr>& keep,
+                                          const templet::types::Data** pending, bool* stable) const {
+    // mapItem holds the current map level in dot notated tags, null for scope
+    const templet::types::Data* mapItem = nullptr;
+    // lastItem holds a pointer to the last evaluated value in the tag
+    const templet::types::Data* lastItem = nullptr;
+    templet::types::DataPtr holder;
+    // Values are computed once per scope that binds the top-level name
+    const Scope* owner = nullptr;
+    for(std::size_t i = 0; i < _steps.size(); ++i) {
+        const auto& step = _steps[i];
+        if(!step.error.empty()) {
+            throw templet::exception::InvalidTagError(step.error);
+        }
+        if(mapItem) {
+            lastItem = mapItem->getItem(step.name, holder);
+        }
+        else {
+            lastItem = scope.find(step.name);
+            owner = &scope.owner(step.name);
+            if(stable) {
+                *stable = owner->stable();
+            }
+        }
+        if(!lastItem) {
+            //throw templet::exception::MissingTagError("Tag name not found: " + step.name);
+            return nullptr;
+        }
+        lastItem = compute_value(*owner, lastItem, holder, keep, stable);
+        if(pending && !lastItem->ready()) {
+            *pending = lastItem;
+            return nullptr;
+        }
+        // Evaluate the array index syntax
+        if(step.indexed) {
             if(lastItem->type() != templet::types::DataType::List) {
                 //throw templet::exception::InvalidTagError("Array syntax can only be used to access elements in lists");
-                lastItem.reset();
-                break;
+                return nullptr;
             }
-            auto listRef = std::cref(lastItem->getList());
-            auto arr = tag.substr(arrPos);
-            while(!arr.empty()) {
-                const auto arrEndPos = arr.find(']');
-                const std::size_t index = parse_array_index(arr.substr(0, arrEndPos + 1));
-                arr.erase(0, arrEndPos + 1);
-                if(!arr.empty() && arr[0] != '[') {
-                    // Valid e.g. for groups[0]users[1]
-                    throw templet::exception::InvalidTagError("Invalid syntax: " + tag);
+            for(std::size_t j = 0; j < step.indexes.size(); ++j) {
+                const auto& index = step.indexes[j];
+                if(!index.error.empty()) {
+                    throw templet::exception::InvalidTagError(index.error);
                 }
-                if(index >= listRef.get().size()) {
+                lastItem = lastItem->getItem(index.value, holder);
+                if(!lastItem) {
                     //throw templet::exception::InvalidTagError("Array index out of bounds: " + tag);
-                    name.clear();
-                    lastItem.reset();
-                    break;
+                    return nullptr;
+                }
+                lastItem = compute_value(*owner, lastItem, holder, keep, stable);
+                if(pending && !lastItem->ready()) {
+                    *pending = lastItem;
+                    return nullptr;
                 }
-                lastItem = listRef.get().at(index);
                 if(lastItem->type() != templet::types::DataType::List) {
                     // All elements accessed via the array index sequence [n]...[m]
                     // must be lists, with the exception of the last element
                     // which may be a string, a map, or a list
-                    if(arr.empty()) {
+                    if(j + 1 == step.indexes.size()) {
                         break;
                     }
                     //throw templet::exception::InvalidTagError("Array syntax can only be used to access elements in lists");
-                    name.clear();
-                    lastItem.reset();
-                    break;
+                    return nullptr;
                 }
-                listRef = std::cref(lastItem->getList());
             }
         }
-        // After the tag name has been parsed and evaluated, if the remaining
-        // tag name is not empty (implying dot notation), the last evaluated
-        // item must be a map value
-        if(!name.empty()) {
+        // If the path continues (implying dot notation), the last
+        // evaluated item must be a map value
+        if(i + 1 < _steps.size()) {
             if(lastItem->type() != templet::types::DataType::Mapper) {
                 throw templet::exception::InvalidTagError("Dot notation can only be used on maps");
             }
 
-            mapRef = std::cref(lastItem->getMap());
+            mapItem = lastItem;
         }
     }
     return lastItem;
 }
 
-/**
- * @brief A helper function for \link parse_tag \endlink that evaluates into a string
- * @param name Tag name to parse
- * @param kv Values to reference
- * @exception templet::exception::InvalidTagError if result is not a string
- * @return Parsed result as a string
- */
-std::string parse_tag_string(const std::string& name, const DataMap& kv) {
-    const auto& res = parse_tag(name, kv);
-    if(!res) {
-            throw templet::exception::MissingTagError("Tag name not found: " + name);
-    }
-    else if(res->type() != templet::types::DataType::String) {
-        throw templet::exception::InvalidTagError("Invalid tag name: Name must reference a string");
+const templet::types::Data* Path::lookup(const Scope& scope, std::vector<templet::types::DataPtr>& keep,
+                                         bool* stable) const {
+    if(_slot < 0) {
+        return resolve(scope, keep, nullptr, stable);
     }
 
-    return res->getValue();
-}
-
-/**
- * @brief A helper function for \link parse_tag \endlink that evaluates into a vector
- * @param name Tag name to parse
- * @param kv Values to reference
- * @exception templet::exception::InvalidTagError if result is not a vector
- * @return Parsed result as a vector
- */
-const templet::types::DataVector& parse_tag_list(const std::string& name, const DataMap& kv) {
-    const auto& res = parse_tag(name, kv);
-    if(!res) {
-            throw templet::exception::MissingTagError("Tag name not found: " + name);
+    const auto& owner = scope.owner(root());
+    const templet::types::Data* value = nullptr;
+    bool resolved = true;
+    if(!owner.recall(_slot, value, resolved)) {
+        std::vector<templet::types::DataPtr> created;
+        value = resolve(scope, created, nullptr, &resolved);
+        owner.remember(_slot, value, resolved, created);
     }
-    else if(res->type() != templet::types::DataType::List) {
-        throw templet::exception::InvalidTagError("Invalid tag name: Name must reference a list");
+    if(stable) {
+        *stable = resolved;
     }
-
-    return res->getList();
+    return value;
 }
 
-} // unnamed namespace
+void Node::evaluate(std::ostream& os, const DataMap& kv) const {
+    evaluate(os, Scope(kv));
+}
 
 void Node::setChildren(std::vector<std::shared_ptr<Node>> /*children*/) {
     throw std::runtime_error("This Node type cannot have children");
@@ -251,17 +503,66 @@ NodeType Node::type() const {
     return NodeType::Invalid;
 }
 
+void Node::collectKeys(std::set<std::string>& /*keys*/) const {
+
+}
+
 void Node::setParent(Node* parent) {
     _parent = parent;
 }
 
+const Node* Node::parent() const {
+    return _parent;
+}
+
+const std::vector<std::shared_ptr<Node>>& Node::children() const {
+    static const std::vector<std::shared_ptr<Node>> none;
+    return none;
+}
+
+Path* Node::path() {
+    return nullptr;
+}
+
+const Path* Node::path() const {
+    return const_cast<Node*>(this)->path();
+}
+
+Text::Text()
+    : Node(), _data(), _size(0) {
+
+}
+
 Text::Text(std::string text)
-    : Node(), _in(std::move(text)) {
+    : Node(), _data(), _size(text.size()) {
+    const auto source = std::make_shared<const std::string>(std::move(text));
+    _data = std::shared_ptr<const char>(source, source->data());
+}
+
+Text::Text(const std::shared_ptr<const std::string>& source, std::size_t offset, std::size_t size)
+    : Node(), _data(source, source->data() + offset), _size(size) {
+
+}
+
+Text::Text(std::shared_ptr<const char> data, std::size_t size)
+    : Node(), _data(std::move(data)), _size(size) {
+
+}
 
+std::string Text::text() const {
+    return std::string(_data.get(), _size);
 }
 
-void Text::evaluate(std::ostream& os, const DataMap& /*kv*/) const {
-    os << _in;
+const char* Text::data() const {
+    return _data.get();
+}
+
+std::size_t Text::size() const {
+    return _size;
+}
+
+void Text::evaluate(std::ostream& os, const Scope& /*scope*/) const {
+    write_stable(os, _data.get(), _size);
 }
 
 NodeType Text::type() const {
@@ -269,33 +570,35 @@ NodeType Text::type() const {
 }
 
 Value::Value(std::string name)
-    : Node(), _name(std::move(name)) {
-    if(!isValidNameExpression(_name)) {
+    : Node(), _path(std::move(name)) {
+    if(!isValidNameExpression(_path.name())) {
         throw templet::exception::InvalidTagError("Variable tag name contains invalid characters");
     }
 }
 
-void Value::evaluate(std::ostream& os, const DataMap& kv) const {
-    try {
-        os << parse_tag_string(_name, kv);
-    }
-    catch(const templet::exception::MissingTagError& ex) {
-        // Default behavior is to just ignore it, effectively
-        // just removing the tag name from the output
-        // TODO: Add user config option to re-throw
-    }
-    catch(...) {
-        throw;
-    }
+const std::string& Value::name() const {
+    return _path.name();
+}
+
+void Value::evaluate(std::ostream& os, const Scope& scope) const {
+    runtime::write_value(os, _path, scope);
 }
 
 NodeType Value::type() const {
     return NodeType::Value;
 }
 
+void Value::collectKeys(std::set<std::string>& keys) const {
+    keys.insert(root_name(_path.name()));
+}
+
+Path* Value::path() {
+    return &_path;
+}
+
 IfValue::IfValue(std::string name)
-    : Node(), _name(std::move(name)), _nodes() {
-    if(!isValidNameExpression(_name)) {
+    : Node(), _path(std::move(name)), _nodes(), _branches() {
+    if(!isValidNameExpression(_path.name())) {
         throw templet::exception::InvalidTagError("If expression tag name contains invalid characters");
     }
 }
@@ -305,27 +608,56 @@ void IfValue::setChildren(std::vector<std::shared_ptr<Node>> children) {
         child->setParent(this);
     }
     _nodes.swap(children);
+
+    const auto branch = std::find_if(_nodes.cbegin(), _nodes.cend(), [](const std::shared_ptr<Node>& node){
+        return node->type() == NodeType::ElifValue || node->type() == NodeType::ElseValue;
+    });
+    std::vector<Branch> branches {Branch{&_path, this, static_cast<std::size_t>(branch - _nodes.cbegin())}};
+    if(branch != _nodes.cend()) {
+        const auto& next = **branch;
+        if(next.type() == NodeType::ElifValue) {
+            const auto& rest = static_cast<const IfValue&>(next)._branches;
+            branches.insert(branches.end(), rest.cbegin(), rest.cend());
+        }
+        else {
+            // An elif or else block inside else is evaluated as part
+            // of the body, which reports the error
+            branches.push_back(Branch{nullptr, &next, next.children().size()});
+        }
+    }
+    _branches.swap(branches);
 }
 
-void IfValue::evaluate(std::ostream& os, const DataMap& kv) const {
-    // Check that the IF condition is TRUE (it's enough that it's been set)
-    const auto parsed_tag = parse_tag(_name, kv);
-    if(parsed_tag) {
-        for(auto& node : _nodes) {
-            if(node->type() == templet::nodes::NodeType::ElifValue ||
-                    node->type() == templet::nodes::NodeType::ElseValue) {
-                break;
+const std::string& IfValue::name() const {
+    return _path.name();
+}
+
+const std::vector<std::shared_ptr<Node>>& IfValue::children() const {
+    return _nodes;
+}
+
+const Node* IfValue::select(const Scope& scope, std::size_t& end, const templet::types::Data** pending) const {
+    for(const auto& branch : _branches) {
+        if(branch.condition) {
+            if(pending && (*pending = runtime::pending(*branch.condition, scope))) {
+                return nullptr;
+            }
+            if(!runtime::is_set(*branch.condition, scope)) {
+                continue;
             }
-            node->evaluate(os, kv);
         }
+        end = branch.end;
+        return branch.body;
     }
-    else {
-        // Do Elif/else block
-        for(auto& node : _nodes) {
-            if(node->type() == templet::nodes::NodeType::ElifValue ||
-                    node->type() == templet::nodes::NodeType::ElseValue) {
-                node->evaluate(os, kv);
-            }
+    return nullptr;
+}
+
+void IfValue::evaluate(std::ostream& os, const Scope& scope) const {
+    std::size_t end = 0;
+    if(const auto body = select(scope, end)) {
+        const auto& nodes = body->children();
+        for(std::size_t i = 0; i < end; ++i) {
+            nodes[i]->evaluate(os, scope);
         }
     }
 }
@@ -334,12 +666,23 @@ NodeType IfValue::type() const {
     return NodeType::IfValue;
 }
 
+void IfValue::collectKeys(std::set<std::string>& keys) const {
+    keys.insert(root_name(_path.name()));
+    for(auto& node : _nodes) {
+        node->collectKeys(keys);
+    }
+}
+
+Path* IfValue::path() {
+    return &_path;
+}
+
 ElifValue::ElifValue(std::string name)
     : IfValue(std::move(name)) {
 
 }
 
-void ElifValue::evaluate(std::ostream& os, const templet::types::DataMap& kv) const {
+void ElifValue::evaluate(std::ostream& os, const Scope& scope) const {
     if(_parent == nullptr) {
         throw templet::exception::InvalidTagError("ELIF statements cannot be declared without a preceding IF statement");
     }
@@ -350,7 +693,7 @@ void ElifValue::evaluate(std::ostream& os, const templet::types::DataMap& kv) co
         throw templet::exception::InvalidTagError("ELIF statements cannot be declared without a preceding IF statement");
     }
 
-    IfValue::evaluate(os, kv);
+    IfValue::evaluate(os, scope);
 }
 
 NodeType ElifValue::type() const {
@@ -364,7 +707,11 @@ void ElseValue::setChildren(std::vector<std::shared_ptr<Node> > children) {
     _nodes.swap(children);
 }
 
-void ElseValue::evaluate(std::ostream& os, const templet::types::DataMap& kv) const {
+const std::vector<std::shared_ptr<Node>>& ElseValue::children() const {
+    return _nodes;
+}
+
+void ElseValue::evaluate(std::ostream& os, const Scope& scope) const {
     if(_parent == nullptr) {
         throw templet::exception::InvalidTagError("ELSE statements cannot be declared without a preceding IF or ELIF statement");
     }
@@ -376,7 +723,7 @@ void ElseValue::evaluate(std::ostream& os, const templet::types::DataMap& kv) co
     }
 
     for(auto& node : _nodes) {
-        node->evaluate(os, kv);
+        node->evaluate(os, scope);
     }
 }
 
@@ -384,11 +731,17 @@ NodeType ElseValue::type() const {
     return NodeType::ElseValue;
 }
 
+void ElseValue::collectKeys(std::set<std::string>& keys) const {
+    for(auto& node : _nodes) {
+        node->collectKeys(keys);
+    }
+}
+
 
 ForValue::ForValue(std::string name, std::string alias)
-    : Node(), _name(std::move(name)), _alias(std::move(alias)), _nodes() {
+    : Node(), _path(std::move(name)), _alias(std::move(alias)), _nodes(), _invariant() {
     // Validate names
-    if(!isValidNameExpression(_name)) {
+    if(!isValidNameExpression(_path.name())) {
         throw templet::exception::InvalidTagError("For expression first tag name contains invalid characters");
     }
     else if(!isValidName(_alias)) {
@@ -397,24 +750,73 @@ ForValue::ForValue(std::string name, std::string alias)
 }
 
 void ForValue::setChildren(std::vector<std::shared_ptr<Node>> children) {
+    std::vector<bool> invariant;
     for(auto& child : children) {
         child->setParent(this);
+        // Text is written as is, copying it would only be slower
+        std::set<std::string> keys;
+        child->collectKeys(keys);
+        invariant.push_back(child->type() != NodeType::Text && keys.count(_alias) == 0);
     }
     _nodes.swap(children);
+    _invariant.swap(invariant);
 }
 
-void ForValue::evaluate(std::ostream& os, const templet::types::DataMap& kv) const {
-    const auto& evaluatedList = parse_tag_list(_name, kv);
-    if(kv.count(_alias)) {
-        throw templet::exception::InvalidTagError("For expression alias name collides with an existing name");
-    }
-    // In a for statement the map entries are copied
-    // and the 'as' values are added with the new name
-    templet::types::DataMap newValues = kv;
-    for(const auto& item : evaluatedList) {
-        newValues[_alias] = item;
-        for(auto& node : _nodes) {
-            node->evaluate(os, newValues);
+const std::string& ForValue::name() const {
+    return _path.name();
+}
+
+const std::string& ForValue::alias() const {
+    return _alias;
+}
+
+std::unique_ptr<templet::types::DataCursor> ForValue::open(const Scope& scope,
+                                                           std::vector<templet::types::DataPtr>& keep,
+                                                           bool* stable) const {
+    return runtime::open_cursor(_path, _alias, scope, keep, stable);
+}
+
+const std::vector<std::shared_ptr<Node>>& ForValue::children() const {
+    return _nodes;
+}
+
+void ForValue::evaluate(std::ostream& os, const Scope& scope) const {
+    std::vector<templet::types::DataPtr> keep;
+    bool stable = true;
+    const auto cursor = open(scope, keep, &stable);
+    // In a for statement the 'as' values are bound
+    // with the new name in a nested scope
+    // A SegmentStream refers to the template and the values instead of
+    // copying them, which a cached string would undo
+    const bool cache = !segment_stream(os) &&
+            std::find(_invariant.cbegin(), _invariant.cend(), true) != _invariant.cend();
+    std::vector<std::string> cached;
+    while(const auto item = cursor->next()) {
+        const Scope itemScope(scope, _alias, item, stable);
+        if(!cache) {
+            for(auto& node : _nodes) {
+                node->evaluate(os, itemScope);
+            }
+            continue;
+        }
+
+        const bool first = cached.empty();
+        if(first) {
+            cached.resize(_nodes.size());
+        }
+        for(std::size_t i = 0; i < _nodes.size(); ++i) {
+            if(!_invariant[i]) {
+                _nodes[i]->evaluate(os, itemScope);
+            }
+            else if(first) {
+                std::ostringstream invariant;
+                _nodes[i]->evaluate(invariant, itemScope);
+                cached[i] = invariant.str();
+                os << cached[i];
+            }
+            else {
+                os << cached[i];
+            }
         }
     }
 }
@@ -423,6 +825,18 @@ NodeType ForValue::type() const {
     return NodeType::ForValue;
 }
 
+void ForValue::collectKeys(std::set<std::string>& keys) const {
+    keys.insert(root_name(_path.name()));
+    keys.insert(_alias);
+    for(auto& node : _nodes) {
+        node->collectKeys(keys);
+    }
+}
+
+Path* ForValue::path() {
+    return &_path;
+}
+
 std::shared_ptr<Node> templet::nodes::parse_value_tag(std::string in) {
     if(!mylib::starts_with(in, "{$") || !mylib::ends_with(in, "}")) {
         throw templet::exception::InvalidTagError("Tag must be enclosed with {$ and }");
@@ -490,3 +904,82 @@ std::shared_ptr<Node> templet::nodes::parse_forvalue_tag(std::string in)
 
     return std::make_shared<ForValue>(tokens[1], tokens[3]);
 }
+
+void templet::nodes::runtime::write_value(std::ostream& os, const std::string& name, const Scope& scope) {
+    write_value(os, Path(name), scope);
+}
+
+void templet::nodes::runtime::write_value(std::ostream& os, const Path& path, const Scope& scope) {
+    try {
+        std::vector<templet::types::DataPtr> keep;
+        bool stable = true;
+        const auto value = path.lookup(scope, keep, &stable);
+        write_tag_value(os, path.name(), value, stable);
+    }
+    catch(const templet::exception::MissingTagError& ex) {
+        // Default behavior is to just ignore it, effectively
+        // just removing the tag name from the output
+        // TODO: Add user config option to re-throw
+    }
+    catch(...) {
+        throw;
+    }
+}
+
+bool templet::nodes::runtime::is_set(const std::string& name, const Scope& scope) {
+    return is_set(Path(name), scope);
+}
+
+bool templet::nodes::runtime::is_set(const Path& path, const Scope& scope) {
+    // Check that the IF condition is TRUE (it's enough that it's been set)
+    std::vector<templet::types::DataPtr> keep;
+    return path.lookup(scope, keep) != nullptr;
+}
+
+const templet::types::Data* templet::nodes::runtime::pending(const std::string& name, const Scope& scope) {
+    if(name.find_first_of(".[") == std::string::npos && isValidName(name)) {
+        // Nothing to walk
+        const auto value = scope.find(name);
+        return value && !value->ready() ? value : nullptr;
+    }
+    return pending(Path(name), scope);
+}
+
+const templet::types::Data* templet::nodes::runtime::pending(const Path& path, const Scope& scope) {
+    std::vector<templet::types::DataPtr> keep;
+    const templet::types::Data* result = nullptr;
+    path.resolve(scope, keep, &result);
+    return result;
+}
+
+std::unique_ptr<templet::types::DataCursor> templet::nodes::runtime::open_cursor(const std::string& name,
+                                                                                const std::string& alias,
+                                                                                const Scope& scope,
+                                                                                std::vector<templet::types::DataPtr>& keep,
+                                                                                bool* stable) {
+    return open_cursor(Path(name), alias, scope, keep, stable);
+}
+
+std::unique_ptr<templet::types::DataCursor> templet::nodes::runtime::open_cursor(const Path& path,
+                                                                                const std::string& alias,
+                                                                                const Scope& scope,
+                                                                                std::vector<templet::types::DataPtr>& keep,
+                                                                                bool* stable) {
+    auto cursor = parse_tag_cursor(path.name(), path.lookup(scope, keep, stable));
+    if(scope.find(alias)) {
+        throw templet::exception::InvalidTagError("For expression alias name collides with an existing name");
+    }
+    return cursor;
+}
+
+void templet::nodes::runtime::memoize_paths(const std::vector<std::shared_ptr<Node>>& nodes) {
+    std::map<std::string, std::vector<Path*>> paths;
+    collect_paths(nodes, paths);
+    int slot = 0;
+    for(const auto& entry : paths) {
+        const int pathSlot = entry.second.size() > 1 ? slot++ : -1;
+        for(const auto path : entry.second) {
+            path->setSlot(pathSlot);
+        }
+    }
+}
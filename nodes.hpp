@@ -28,6 +28,8 @@ THE SOFTWARE.
 #define NODES_HPP
 
 #include <cstddef>
+#include <memory>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -71,6 +73,212 @@ namespace nodes {
 
 using ::templet::types::DataMap;
 
+/**
+ * @brief The Scope class looks up names during evaluation
+ *
+ * The root scope looks names up from a map of values, and each for
+ * block adds a scope that binds its alias to the current element.
+ * Scopes borrow the values, which must outlive the scope.
+ */
+class Scope {
+private:
+    /**
+     * @brief A resolved path, see \link Path::slot \endlink
+     */
+    struct Memo {
+        int slot;
+        const types::Data* value;
+        bool stable;
+    };
+
+    const DataMap* _values;
+    const Scope* _parent;
+    const std::string* _name;
+    const types::Data* _value;
+    bool _stable;
+    // Paths resolved from the name this scope binds, the first
+    // ones are stored inline because a scope is made per element
+    static const std::size_t InlineMemos = 4;
+    mutable Memo _inline[InlineMemos];
+    mutable std::size_t _memos;
+    mutable std::vector<Memo> _memo;
+    mutable std::vector<types::DataPtr> _keep;
+    // Values computed on demand from the name this scope binds
+    mutable std::vector<std::pair<const types::Data*, types::DataPtr>> _computed;
+
+public:
+    /**
+     * @brief Construct a root scope
+     * @param values Map of values
+     */
+    explicit Scope(const DataMap& values);
+
+    /**
+     * @brief Construct a scope that binds a name to a value
+     * @param parent Scope where other names are looked up from
+     * @param name Name to bind
+     * @param value Value to bind
+     * @param stable False if the value is destroyed before the output is used, see \link stable \endlink
+     */
+    Scope(const Scope& parent, const std::string& name, const types::Data* value, bool stable = true);
+
+    /**
+     * @brief Look up a name
+     * @param name Top-level name
+     * @return Value or null if the name is not found
+     */
+    const types::Data* find(const std::string& name) const;
+
+    /**
+     * @brief Get the scope that a name is looked up from
+     * @param name Top-level name
+     * @return Scope that binds the name, or the root scope if no scope does
+     */
+    const Scope& owner(const std::string& name) const;
+
+    /**
+     * @brief Check whether the values looked up from this scope outlive the output
+     *
+     * The values of the root scope belong to the caller. A bound value is
+     * stable unless it's an element of a list that was created or computed
+     * during the render. A \link templet::SegmentStream SegmentStream \endlink
+     * may refer to stable values, all others are copied into it.
+     *
+     * @return True if the values are stable, otherwise false
+     */
+    bool stable() const;
+
+    /**
+     * @brief Find a path resolved in this scope
+     * @param slot Slot of the path
+     * @param value Receives the value if the path is found
+     * @param stable Receives whether the value is stable, see \link Path::resolve \endlink
+     * @return True if the path is found, otherwise false
+     */
+    bool recall(int slot, const types::Data*& value, bool& stable) const;
+
+    /**
+     * @brief Store a resolved path in this scope
+     * @param slot Slot of the path
+     * @param value Value of the path, may be null
+     * @param stable Whether the value is stable
+     * @param keep Owners of created values, moved into this scope
+     */
+    void remember(int slot, const types::Data* value, bool stable, std::vector<types::DataPtr>& keep) const;
+
+    /**
+     * @brief Get the computed value of data that is computed on demand
+     *
+     * The value is computed once per scope. Paths compute their values
+     * in the scope that binds their top-level name, i.e. once per render
+     * or once per element of a for block, see \link types::Data::compute \endlink.
+     *
+     * @param value Value that must outlive this scope
+     * @exception std::runtime_error if the value can't be computed
+     * @return Computed value, or value if it isn't computed on demand
+     */
+    const types::Data* computed(const types::Data* value) const;
+};
+
+/**
+ * @brief The Path class is a tag name that is parsed once
+ *
+ * E.g. config.servers[1].ip. Syntax errors are reported when the
+ * path is resolved and the invalid part is reached, exactly like
+ * when the name is parsed during evaluation.
+ */
+class Path {
+private:
+    /**
+     * @brief A list index, e.g. [1]
+     */
+    struct Index {
+        std::size_t value;
+        std::string error;  ///< Error thrown when the index is reached
+    };
+
+    /**
+     * @brief A dot-separated part of the path, e.g. servers[1]
+     */
+    struct Step {
+        std::string name;
+        std::string error;  ///< Error thrown when the step is reached
+        bool indexed;
+        std::vector<Index> indexes;
+    };
+
+    std::string _name;
+    std::vector<Step> _steps;
+    int _slot;
+
+public:
+    /**
+     * @brief Parse a tag name into a path
+     * @param name Tag name
+     */
+    explicit Path(std::string name);
+
+    /**
+     * @brief Get the tag name
+     * @return Tag name
+     */
+    const std::string& name() const;
+
+    /**
+     * @brief Get the top-level name
+     * @return Top-level name, e.g. config for config.servers[1].ip
+     */
+    const std::string& root() const;
+
+    /**
+     * @brief Set the memo slot of the path
+     *
+     * A path with a slot is resolved once per scope of its top-level
+     * name, i.e. once per render or once per element of the for block
+     * that binds it. Paths with the same name share a slot.
+     *
+     * @param slot Slot or -1 to resolve on every use
+     */
+    void setSlot(int slot);
+
+    /**
+     * @brief Get the memo slot of the path
+     * @return Slot or -1 if not set
+     */
+    int slot() const;
+
+    /**
+     * @brief Resolve the path to a value
+     *
+     * The values are borrowed, so no reference counts are touched unless
+     * a data type has to create a value, in which case it's added to keep.
+     *
+     * @param scope Scope to look up the top-level name from
+     * @param keep Owners of created values, must outlive the returned value
+     * @param pending If not null, resolving stops at a value that isn't ready and stores it here
+     * @param stable If not null, receives false if a value on the path was created or computed,
+     * or if the scope of the top-level name isn't stable, see \link Scope::stable \endlink
+     * @exception templet::exception::InvalidTagError if the name is invalid
+     * @return Value or null if not found
+     */
+    const types::Data* resolve(const Scope& scope, std::vector<types::DataPtr>& keep,
+                               const types::Data** pending = nullptr, bool* stable = nullptr) const;
+
+    /**
+     * @brief Resolve the path to a value, using the memo slot
+     *
+     * If the path has a slot, created values are owned by the scope
+     * that binds the top-level name instead of keep.
+     *
+     * @param scope Scope to look up the top-level name from
+     * @param keep Owners of created values, must outlive the returned value
+     * @param stable If not null, receives whether the value is stable, see \link resolve \endlink
+     * @exception templet::exception::InvalidTagError if the name is invalid
+     * @return Value or null if not found
+     */
+    const types::Data* lookup(const Scope& scope, std::vector<types::DataPtr>& keep, bool* stable = nullptr) const;
+};
+
 /**
  * @brief The NodeType enum describes what the node represents
  */
@@ -108,10 +316,25 @@ public:
     /**
      * @brief Evaluates the Node and outputs the computed value in ostream os
      */
-    virtual void evaluate(std::ostream& /*os*/, const DataMap& /*kv*/) const = 0;
+    void evaluate(std::ostream& os, const DataMap& kv) const;
+
+    /**
+     * @brief Evaluates the Node with names looked up from a scope
+     */
+    virtual void evaluate(std::ostream& /*os*/, const Scope& /*scope*/) const = 0;
 
     virtual NodeType type() const;
 
+    /**
+     * @brief Collect the top-level value names this node reads
+     *
+     * Only the first part of a name is collected, e.g. config.servers[1]
+     * is collected as config. Child nodes are included.
+     *
+     * @param keys Set where the names are inserted
+     */
+    virtual void collectKeys(std::set<std::string>& /*keys*/) const;
+
     /**
      * @brief Set the node's parent
      *
@@ -120,25 +343,87 @@ public:
      * @param parent Parent node
      */
     void setParent(Node* parent);
+
+    /**
+     * @brief Get the node's parent
+     * @return Parent node or null for top-level nodes
+     */
+    const Node* parent() const;
+
+    /**
+     * @brief Get the child nodes
+     * @return Child nodes, empty for node types that can't have children
+     */
+    virtual const std::vector<std::shared_ptr<Node>>& children() const;
+
+    /**
+     * @brief Get the path of the value this node reads
+     * @return Path or null for node types that don't read a value
+     */
+    virtual Path* path();
+
+    const Path* path() const;
 };
 
 /**
  * @brief The Text class represents a plain text block in the template
+ *
+ * The text is not copied out of the template. The node refers to a
+ * range of a source buffer and shares its ownership.
  */
 class Text : public Node {
 private:
-    std::string _in;
+    std::shared_ptr<const char> _data;
+    std::size_t _size;
 
 public:
-    Text() = default;
+    Text();
 
     /**
-     * @brief Construct a text node with text
+     * @brief Construct a text node that owns its text
      * @param text Text block from the template
      */
     Text(std::string text);
 
-    void evaluate(std::ostream& os, const DataMap& /*kv*/) const override;
+    /**
+     * @brief Construct a text node that refers to a range of a source buffer
+     * @param source Template text
+     * @param offset Start of the text block
+     * @param size Length of the text block
+     */
+    Text(const std::shared_ptr<const std::string>& source, std::size_t offset, std::size_t size);
+
+    /**
+     * @brief Construct a text node that refers to a range of memory
+     *
+     * The aliasing constructor of std::shared_ptr can point data into
+     * a buffer owned by another object. Data that lives forever, like
+     * string literals, doesn't need an owner.
+     *
+     * @param data Start of the text block
+     * @param size Length of the text block
+     */
+    Text(std::shared_ptr<const char> data, std::size_t size);
+
+    /**
+     * @brief Get a copy of the text block
+     * @return Text block
+     */
+    std::string text() const;
+
+    /**
+     * @brief Get the start of the text block
+     * @return Pointer to the first character
+     */
+    const char* data() const;
+
+    /**
+     * @brief Get the length of the text block
+     * @return Length in bytes
+     */
+    std::size_t size() const;
+
+    void evaluate(std::ostream& os, const Scope& /*scope*/) const override;
 
     NodeType type() const override;
 };
@@ -150,7 +435,7 @@ public:
  */
 class Value : public Node {
 private:
-    std::string _name;
+    Path _path;
 
 public:
     /**
@@ -163,20 +448,46 @@ public:
      */
     Value(std::string name);
 
-    void evaluate(std::ostream& os, const DataMap& kv) const override;
+    /**
+     * @brief Get the tag name
+     * @return Tag name
+     */
+    const std::string& name() const;
+
+    void evaluate(std::ostream& os, const Scope& scope) const override;
 
     NodeType type() const override;
+
+    void collectKeys(std::set<std::string>& keys) const override;
+
+    using Node::path;
+    Path* path() override;
 };
 
 /**
  * @brief The IfValue class represents a conditional block in the template
  *
  * Conditional blocks can be omitted/included from the output
+ *
+ * An elif or else block is the last child of the block before it. When
+ * the children are set, the chain is flattened into a list of branches,
+ * so evaluation checks one condition per branch and jumps to its body.
  */
 class IfValue : public Node {
 protected:
-    std::string _name;
+    /**
+     * @brief A branch of an if-elif-else chain
+     */
+    struct Branch {
+        const Path* condition;  ///< Condition or null for else
+        const Node* body;       ///< Node whose child nodes are the body
+        std::size_t end;        ///< End of the body in the child nodes
+    };
+
+    Path _path;
     std::vector<std::shared_ptr<Node>> _nodes;
+    // This block first, then the elif and else blocks that follow it
+    std::vector<Branch> _branches;
 
 public:
     /**
@@ -189,11 +500,40 @@ public:
      */
     IfValue(std::string name);
 
+    /**
+     * @brief Get the tag name
+     * @return Tag name
+     */
+    const std::string& name() const;
+
+    /**
+     * @brief Set child nodes
+     *
+     * An elif block among the children must have its own children set.
+     *
+     * @param children Child nodes
+     */
     void setChildren(std::vector<std::shared_ptr<Node>> children) override;
+    const std::vector<std::shared_ptr<Node>>& children() const override;
 
-    void evaluate(std::ostream& os, const DataMap& kv) const override;
+    /**
+     * @brief Find the branch whose condition is true
+     * @param scope Scope to look up the conditions from
+     * @param end Receives the end of the body in the child nodes of the returned node
+     * @param pending If not null, no branch is chosen while a condition isn't ready, and the value is stored here
+     * @exception templet::exception::InvalidTagError if a condition is invalid
+     * @return Node whose child nodes are the body, or null if no branch is taken
+     */
+    const Node* select(const Scope& scope, std::size_t& end, const types::Data** pending = nullptr) const;
+
+    void evaluate(std::ostream& os, const Scope& scope) const override;
 
     NodeType type() const override;
+
+    void collectKeys(std::set<std::string>& keys) const override;
+
+    using Node::path;
+    Path* path() override;
 };
 
 /**
@@ -203,7 +543,7 @@ class ElifValue : public IfValue {
 public:
     ElifValue(std::string name);
 
-    void evaluate(std::ostream& os, const DataMap& kv) const override;
+    void evaluate(std::ostream& os, const Scope& scope) const override;
 
     virtual NodeType type() const override;
 };
@@ -220,31 +560,77 @@ public:
     ElseValue() = default;
 
     void setChildren(std::vector<std::shared_ptr<Node>> children) override;
+    const std::vector<std::shared_ptr<Node>>& children() const override;
 
-    void evaluate(std::ostream& os, const DataMap& kv) const override;
+    void evaluate(std::ostream& os, const Scope& scope) const override;
 
     NodeType type() const override;
+
+    void collectKeys(std::set<std::string>& keys) const override;
 };
 
 /**
  * @brief The ForValue class represents a for statement block
  *
- * For statements can be used to traverse lists
+ * For statements can be used to traverse lists and streams
+ *
+ * Child nodes that don't read the alias render the same output for
+ * every element. Their output is rendered for the first element and
+ * copied for the rest.
  */
 class ForValue : public Node {
 private:
-    std::string _name;
+    Path _path;
     std::string _alias;
     std::vector<std::shared_ptr<Node>> _nodes;
+    // Child nodes that don't read the alias are rendered once per loop,
+    // except into a SegmentStream which would then copy their output
+    std::vector<bool> _invariant;
 
 public:
     ForValue(std::string name, std::string alias);
 
+    /**
+     * @brief Get the list name
+     * @return List name
+     */
+    const std::string& name() const;
+
+    /**
+     * @brief Get the name bound to each element
+     * @return Alias name
+     */
+    const std::string& alias() const;
+
+    /**
+     * @brief Open a cursor to the elements of the list
+     * @param scope Scope to look up the list from
+     * @param keep Owners of created values, must outlive the cursor
+     * @param stable If not null, receives whether the elements are stable, see \link Scope::stable \endlink
+     * @exception templet::exception::MissingTagError if the list is not found
+     * @exception templet::exception::InvalidTagError if the name doesn't reference a list or the alias collides with an existing name
+     * @return Cursor to the elements
+     */
+    std::unique_ptr<types::DataCursor> open(const Scope& scope, std::vector<types::DataPtr>& keep,
+                                            bool* stable = nullptr) const;
+
     void setChildren(std::vector<std::shared_ptr<Node>> children) override;
+    const std::vector<std::shared_ptr<Node>>& children() const override;
 
-    void evaluate(std::ostream& os, const DataMap& kv) const override;
+    void evaluate(std::ostream& os, const Scope& scope) const override;
 
     NodeType type() const override;
+
+    /**
+     * @brief Collects the list name and the names read by child nodes
+     *
+     * The alias is collected as well because the loop checks that
+     * it does not collide with an existing name.
+     */
+    void collectKeys(std::set<std::string>& keys) const override;
+
+    using Node::path;
+    Path* path() override;
 };
 
 /**
@@ -292,6 +678,96 @@ std::shared_ptr<Node> parse_elifvalue_tag(std::string in);
  */
 std::shared_ptr<Node> parse_forvalue_tag(std::string in);
 
+/**
+ * The runtime functions evaluate single tags. The nodes use them, and
+ * so does the C++ code generated from templates by templetc.
+ */
+namespace runtime {
+
+/**
+ * @brief Write the value of a variable tag
+ *
+ * Nothing is written if the name is not found
+ *
+ * @param os Output stream
+ * @param name Tag name
+ * @param scope Scope to look up the name from
+ * @exception templet::exception::InvalidTagError if the name doesn't reference a string or a number
+ */
+void write_value(std::ostream& os, const std::string& name, const Scope& scope);
+
+/**
+ * @brief Write the value of a variable tag
+ * \sa write_value
+ */
+void write_value(std::ostream& os, const Path& path, const Scope& scope);
+
+/**
+ * @brief Check the condition of an if or elif tag
+ * @param name Tag name
+ * @param scope Scope to look up the name from
+ * @exception templet::exception::InvalidTagError if the name is invalid
+ * @return True if the name is set, otherwise false
+ */
+bool is_set(const std::string& name, const Scope& scope);
+
+/**
+ * @brief Check the condition of an if or elif tag
+ * \sa is_set
+ */
+bool is_set(const Path& path, const Scope& scope);
+
+/**
+ * @brief Find a value that a tag name would have to wait for
+ *
+ * Every value on the path is checked, e.g. both config and
+ * config.server for config.server.ip
+ *
+ * @param name Tag name
+ * @param scope Scope to look up the name from
+ * @exception templet::exception::InvalidTagError if the name is invalid
+ * @return First value on the path that isn't ready, or null if there's none
+ */
+const types::Data* pending(const std::string& name, const Scope& scope);
+
+/**
+ * @brief Find a value that a path would have to wait for
+ * \sa pending
+ */
+const types::Data* pending(const Path& path, const Scope& scope);
+
+/**
+ * @brief Open a cursor for a for tag
+ * @param name List name
+ * @param alias Name bound to each element
+ * @param scope Scope to look up the name from
+ * @param keep Owners of created values, must outlive the cursor
+ * @param stable If not null, receives whether the elements are stable, see \link Scope::stable \endlink
+ * @exception templet::exception::MissingTagError if the name is not found
+ * @exception templet::exception::InvalidTagError if the name doesn't reference a list or the alias collides with an existing name
+ * @return Cursor to the elements
+ */
+std::unique_ptr<types::DataCursor> open_cursor(const std::string& name, const std::string& alias, const Scope& scope,
+                                               std::vector<types::DataPtr>& keep, bool* stable = nullptr);
+
+/**
+ * @brief Open a cursor for a for tag
+ * \sa open_cursor
+ */
+std::unique_ptr<types::DataCursor> open_cursor(const Path& path, const std::string& alias, const Scope& scope,
+                                               std::vector<types::DataPtr>& keep, bool* stable = nullptr);
+
+/**
+ * @brief Give paths that are used more than once a memo slot
+ *
+ * See \link Path::setSlot \endlink
+ *
+ * @param nodes Top-level nodes of a template
+ */
+void memoize_paths(const std::vector<std::shared_ptr<Node>>& nodes);
+
+} // namespace runtime
+
 } // namespace nodes
 } // namespace templet
 
@@ -29,6 +29,9 @@ THE SOFTWARE.
 
 #include <algorithm>
 #include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace mylib {
 
@@ -38,6 +41,51 @@ std::unique_ptr<T> make_unique(Args&&... args)
     return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
 }
 
+/**
+ * @brief Storage for one object that is created again in place
+ *
+ * E.g. the element that a cursor returns is replaced by a new object
+ * for every element instead of being changed, without allocating.
+ */
+template<typename T>
+class InPlace {
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage;
+    T* _object;
+
+public:
+    InPlace() : _storage(), _object(nullptr) {}
+
+    InPlace(const InPlace&) = delete;
+    InPlace& operator=(const InPlace&) = delete;
+
+    ~InPlace() {
+        reset();
+    }
+
+    /**
+     * @brief Destroy the current object and create a new one
+     * @param args Constructor arguments
+     * @return New object
+     */
+    template<typename... Args>
+    T& emplace(Args&&... args) {
+        reset();
+        _object = new (&_storage) T(std::forward<Args>(args)...);
+        return *_object;
+    }
+
+    /**
+     * @brief Destroy the current object
+     */
+    void reset() {
+        if(_object) {
+            _object->~T();
+            _object = nullptr;
+        }
+    }
+};
+
 } // namespace mylib
 
 #endif
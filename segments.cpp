@@ -0,0 +1,382 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "segments.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TEMPLET_WRITEV
+#include <climits>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#define TEMPLET_SENDFILE
+#include <sys/sendfile.h>
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+#define TEMPLET_COPY_FILE_RANGE
+#endif
+#endif
+
+using namespace templet;
+
+namespace {
+
+const std::size_t BlockSize = 16384;
+
+/**
+ * @brief Get the stream word that points to a SegmentStream
+ */
+int segment_index() {
+    static const int index = std::ios_base::xalloc();
+    return index;
+}
+
+#ifdef TEMPLET_WRITEV
+[[noreturn]] void write_error() {
+    throw std::runtime_error(std::string("Unable to write segments: ") + std::strerror(errno));
+}
+
+/**
+ * @brief Read a range of a file into a buffer
+ * @return Number of bytes read, less than size only at the end of the file
+ */
+std::size_t read_range(int fd, std::uint64_t offset, char* buffer, std::size_t size) {
+    std::size_t done = 0;
+    while(done < size) {
+        const auto count = ::pread(fd, buffer + done, size - done, static_cast<off_t>(offset + done));
+        if(count < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            write_error();
+        }
+        if(count == 0) {
+            break;
+        }
+        done += static_cast<std::size_t>(count);
+    }
+    return done;
+}
+
+void write_all(int fd, const char* data, std::size_t size) {
+    while(size > 0) {
+        const auto count = ::write(fd, data, size);
+        if(count < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            write_error();
+        }
+        data += count;
+        size -= static_cast<std::size_t>(count);
+    }
+}
+
+/**
+ * @brief Check if a kernel copy failed because it doesn't support the descriptors
+ */
+bool unsupported(int error) {
+    return error == EINVAL || error == ENOSYS || error == EXDEV || error == EBADF || error == EOPNOTSUPP;
+}
+
+/**
+ * @brief Copy a range of a file to a file descriptor
+ *
+ * The kernel copies the range if it can, otherwise it's copied
+ * through a buffer.
+ */
+void transfer(int out, int in, std::uint64_t offset, std::size_t size) {
+#ifdef TEMPLET_COPY_FILE_RANGE
+    // Works between regular files and may share their blocks
+    loff_t from = static_cast<loff_t>(offset);
+    while(size > 0) {
+        const auto count = ::copy_file_range(in, &from, out, nullptr, size, 0);
+        if(count > 0) {
+            size -= static_cast<std::size_t>(count);
+        }
+        else if(count == 0) {
+            throw std::runtime_error("Unable to write segments: File is shorter than its segment");
+        }
+        else if(errno != EINTR) {
+            if(!unsupported(errno)) {
+                write_error();
+            }
+            break;
+        }
+    }
+    offset = static_cast<std::uint64_t>(from);
+#endif
+#ifdef TEMPLET_SENDFILE
+    // Works to any descriptor, like pipes and sockets
+    off_t position = static_cast<off_t>(offset);
+    while(size > 0) {
+        const auto count = ::sendfile(out, in, &position, size);
+        if(count > 0) {
+            size -= static_cast<std::size_t>(count);
+        }
+        else if(count == 0) {
+            throw std::runtime_error("Unable to write segments: File is shorter than its segment");
+        }
+        else if(errno != EINTR) {
+            if(!unsupported(errno)) {
+                write_error();
+            }
+            break;
+        }
+    }
+    offset = static_cast<std::uint64_t>(position);
+#endif
+    char buffer[65536];
+    while(size > 0) {
+        const auto count = read_range(in, offset, buffer, std::min(size, sizeof(buffer)));
+        if(count == 0) {
+            throw std::runtime_error("Unable to write segments: File is shorter than its segment");
+        }
+        write_all(out, buffer, count);
+        offset += count;
+        size -= count;
+    }
+}
+#endif
+
+} // unnamed namespace
+
+SegmentBuffer::SegmentBuffer(std::size_t minReference)
+    : _blocks(), _block(0), _segments(), _pending(nullptr), _minReference(minReference) {
+
+}
+
+void SegmentBuffer::append(const char* data, std::size_t size) {
+    if(size == 0) {
+        return;
+    }
+    if(!_segments.empty() && _segments.back().data && _segments.back().data + _segments.back().size == data) {
+        _segments.back().size += size;
+        return;
+    }
+    _segments.push_back(Segment{data, size, -1, 0});
+}
+
+void SegmentBuffer::flushPending() {
+    append(_pending, static_cast<std::size_t>(pptr() - _pending));
+    _pending = pptr();
+}
+
+SegmentBuffer::int_type SegmentBuffer::overflow(int_type ch) {
+    flushPending();
+    if(_block == _blocks.size()) {
+        _blocks.emplace_back(new char[BlockSize]);
+    }
+    char* block = _blocks[_block++].get();
+    setp(block, block + BlockSize);
+    _pending = block;
+    if(!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize SegmentBuffer::xsputn(const char* s, std::streamsize n) {
+    std::streamsize written = 0;
+    while(written < n) {
+        if(pptr() == epptr()) {
+            overflow(traits_type::eof());
+        }
+        const auto count = std::min(n - written, static_cast<std::streamsize>(epptr() - pptr()));
+        std::memcpy(pptr(), s + written, static_cast<std::size_t>(count));
+        // pbump takes an int, count is at most BlockSize
+        pbump(static_cast<int>(count));
+        written += count;
+    }
+    return n;
+}
+
+void SegmentBuffer::reference(const char* data, std::size_t size) {
+    if(size < _minReference) {
+        xsputn(data, static_cast<std::streamsize>(size));
+        return;
+    }
+    flushPending();
+    append(data, size);
+}
+
+void SegmentBuffer::file(int fd, std::uint64_t offset, std::size_t size) {
+    flushPending();
+    if(size == 0) {
+        return;
+    }
+    if(!_segments.empty() && _segments.back().file == fd &&
+            _segments.back().offset + _segments.back().size == offset) {
+        _segments.back().size += size;
+        return;
+    }
+    _segments.push_back(Segment{nullptr, size, fd, offset});
+}
+
+const std::vector<Segment>& SegmentBuffer::segments() {
+    flushPending();
+    return _segments;
+}
+
+void SegmentBuffer::clear() {
+    _segments.clear();
+    _blocks.resize(std::min<std::size_t>(_blocks.size(), 1));
+    _block = 0;
+    setp(nullptr, nullptr);
+    _pending = nullptr;
+}
+
+SegmentStream::SegmentStream(std::size_t minReference)
+    : std::ostream(nullptr), _buffer(minReference), _copy(false) {
+    rdbuf(&_buffer);
+    pword(segment_index()) = this;
+}
+
+void SegmentStream::reference(const char* data, std::size_t size) {
+    if(_copy) {
+        write(data, static_cast<std::streamsize>(size));
+        return;
+    }
+    _buffer.reference(data, size);
+}
+
+void SegmentStream::file(int fd, std::uint64_t offset, std::size_t size) {
+    _buffer.file(fd, offset, size);
+}
+
+void SegmentStream::setCopying(bool copy) {
+    _copy = copy;
+}
+
+bool SegmentStream::copying() const {
+    return _copy;
+}
+
+const std::vector<Segment>& SegmentStream::segments() {
+    return _buffer.segments();
+}
+
+void SegmentStream::clear() {
+    _buffer.clear();
+    std::ostream::clear();
+}
+
+SegmentStream* templet::segment_stream(std::ostream& os) {
+    auto segments = static_cast<SegmentStream*>(os.pword(segment_index()));
+    // The word is copied by copyfmt, so check that it's the same stream
+    if(segments && segments->rdbuf() == os.rdbuf()) {
+        return segments;
+    }
+    return nullptr;
+}
+
+void templet::write_stable(std::ostream& os, const char* data, std::size_t size) {
+    if(const auto segments = segment_stream(os)) {
+        segments->reference(data, size);
+    }
+    else {
+        os.write(data, static_cast<std::streamsize>(size));
+    }
+}
+
+std::size_t templet::write_segments(int fd, const std::vector<Segment>& segments) {
+#ifdef TEMPLET_WRITEV
+    std::vector<struct iovec> pending;
+    pending.reserve(std::min<std::size_t>(segments.size(), IOV_MAX));
+    std::size_t next = 0;
+    std::size_t total = 0;
+    while(next < segments.size() || !pending.empty()) {
+        while(next < segments.size() && pending.size() < IOV_MAX && segments[next].file == -1) {
+            struct iovec item;
+            item.iov_base = const_cast<char*>(segments[next].data);
+            item.iov_len = segments[next].size;
+            pending.push_back(item);
+            ++next;
+        }
+        if(pending.empty()) {
+            const auto& segment = segments[next++];
+            transfer(fd, segment.file, segment.offset, segment.size);
+            total += segment.size;
+            continue;
+        }
+        const auto written = ::writev(fd, pending.data(), static_cast<int>(pending.size()));
+        if(written < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            write_error();
+        }
+        total += static_cast<std::size_t>(written);
+        // Drop the written items and continue a partially written one
+        auto remaining = static_cast<std::size_t>(written);
+        auto first = pending.begin();
+        while(first != pending.end() && remaining >= first->iov_len) {
+            remaining -= first->iov_len;
+            ++first;
+        }
+        if(first != pending.end()) {
+            first->iov_base = static_cast<char*>(first->iov_base) + remaining;
+            first->iov_len -= remaining;
+        }
+        pending.erase(pending.begin(), first);
+    }
+    return total;
+#else
+    (void)fd;
+    (void)segments;
+    throw std::runtime_error("writev is not available on this platform");
+#endif
+}
+
+void templet::write_segments(std::ostream& os, const std::vector<Segment>& segments) {
+    for(const auto& segment : segments) {
+        if(segment.file == -1) {
+            os.write(segment.data, static_cast<std::streamsize>(segment.size));
+            continue;
+        }
+#ifdef TEMPLET_WRITEV
+        char buffer[65536];
+        std::size_t done = 0;
+        while(done < segment.size) {
+            const auto count = read_range(segment.file, segment.offset + done, buffer,
+                                          std::min(segment.size - done, sizeof(buffer)));
+            if(count == 0) {
+                throw std::runtime_error("Unable to write segments: File is shorter than its segment");
+            }
+            os.write(buffer, static_cast<std::streamsize>(count));
+            done += count;
+        }
+#endif
+    }
+}
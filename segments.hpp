@@ -0,0 +1,235 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef SEGMENTS_HPP
+#define SEGMENTS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <vector>
+
+namespace templet {
+
+/**
+ * @brief A range of memory or of a file in rendered output
+ */
+struct Segment {
+    const char* data;       ///< Start of the range in memory, nullptr for a file range
+    std::size_t size;       ///< Length of the range
+    int file;               ///< File descriptor of a file range, otherwise -1
+    std::uint64_t offset;   ///< Offset of a file range
+};
+
+/**
+ * @brief The SegmentBuffer class is the stream buffer of \link SegmentStream \endlink
+ *
+ * Written bytes are copied into blocks that never move, so segments
+ * that point into them stay valid until the buffer is cleared.
+ */
+class SegmentBuffer : public std::streambuf {
+private:
+    std::vector<std::unique_ptr<char[]>> _blocks;
+    std::size_t _block;
+    std::vector<Segment> _segments;
+    char* _pending;
+    std::size_t _minReference;
+
+    /**
+     * @brief Add the bytes that were copied since the last segment
+     */
+    void flushPending();
+
+    void append(const char* data, std::size_t size);
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* s, std::streamsize n) override;
+
+public:
+    /**
+     * @brief Construct a SegmentBuffer
+     * @param minReference Referenced ranges shorter than this are copied
+     */
+    explicit SegmentBuffer(std::size_t minReference);
+
+    SegmentBuffer(const SegmentBuffer&) = delete;
+    SegmentBuffer& operator=(const SegmentBuffer&) = delete;
+
+    /**
+     * @brief Add a segment that refers to memory instead of copying it
+     * @param data Start of the range
+     * @param size Length of the range
+     */
+    void reference(const char* data, std::size_t size);
+
+    /**
+     * @brief Add a segment that refers to a range of a file
+     * @param fd File descriptor that stays open while the segments are used
+     * @param offset Start of the range
+     * @param size Length of the range
+     */
+    void file(int fd, std::uint64_t offset, std::size_t size);
+
+    /**
+     * @brief Get the segments written so far
+     * @return Segments in output order
+     */
+    const std::vector<Segment>& segments();
+
+    /**
+     * @brief Remove all segments, keeping the first block for reuse
+     */
+    void clear();
+};
+
+/**
+ * @brief The SegmentStream class collects rendered output as a list of segments
+ *
+ * Template text and string values are not copied into the stream. The
+ * segments point to them where they are, and only formatted numbers and
+ * short ranges are copied. Render into the stream as into any other
+ * std::ostream and write the segments with \link write_segments \endlink.
+ *
+ * Example usage:
+ *
+ * templet::SegmentStream out;\n
+ * tpl.render(values, out);\n
+ * templet::write_segments(fd, out.segments());
+ *
+ * The segments are valid while the template and the values are alive
+ * and unchanged, and until the stream is cleared. Values created or
+ * computed during the render are copied.
+ */
+class SegmentStream : public std::ostream {
+private:
+    SegmentBuffer _buffer;
+    bool _copy;
+
+public:
+    /**
+     * @brief Construct a SegmentStream
+     * @param minReference Ranges shorter than this are copied, because
+     * a segment costs more than copying a few bytes
+     */
+    explicit SegmentStream(std::size_t minReference = 64);
+
+    /**
+     * @brief Add a segment that refers to memory instead of copying it
+     *
+     * The range is copied while \link copying \endlink is set.
+     *
+     * @param data Start of the range
+     * @param size Length of the range
+     */
+    void reference(const char* data, std::size_t size);
+
+    /**
+     * @brief Add a segment that refers to a range of a file
+     *
+     * Must not be called while \link copying \endlink is set.
+     *
+     * @param fd File descriptor that stays open while the segments are used
+     * @param offset Start of the range
+     * @param size Length of the range
+     */
+    void file(int fd, std::uint64_t offset, std::size_t size);
+
+    /**
+     * @brief Set whether referenced ranges are copied
+     *
+     * The renderer sets it while it writes values that are created
+     * during the render, because they are destroyed before the
+     * segments are written.
+     *
+     * @param copy True to copy referenced ranges
+     */
+    void setCopying(bool copy);
+
+    /**
+     * @brief Check whether referenced ranges are copied
+     * @return True if they are copied, otherwise false
+     */
+    bool copying() const;
+
+    /**
+     * @brief Get the segments written so far
+     * @return Segments in output order
+     */
+    const std::vector<Segment>& segments();
+
+    /**
+     * @brief Remove all segments
+     */
+    void clear();
+};
+
+/**
+ * @brief Get the SegmentStream behind an output stream
+ * @param os Output stream
+ * @return The stream if os is a SegmentStream, otherwise nullptr
+ */
+SegmentStream* segment_stream(std::ostream& os);
+
+/**
+ * @brief Write a range that stays valid for as long as the output is used
+ *
+ * The range is referred to when os is a \link SegmentStream \endlink,
+ * otherwise it's written as usual.
+ *
+ * @param os Output stream
+ * @param data Start of the range
+ * @param size Length of the range
+ */
+void write_stable(std::ostream& os, const char* data, std::size_t size);
+
+/**
+ * @brief Write segments to a file descriptor
+ *
+ * Memory ranges are written with writev. File ranges are copied by the
+ * kernel with copy_file_range or sendfile on Linux, and with pread and
+ * write elsewhere. Partial writes and interrupted calls are continued.
+ *
+ * @param fd Blocking file or socket descriptor
+ * @param segments Segments to write
+ * @exception std::runtime_error if writing fails or writev is not available
+ * @return Number of bytes written
+ */
+std::size_t write_segments(int fd, const std::vector<Segment>& segments);
+
+/**
+ * @brief Write segments to an output stream
+ * @param os Output stream
+ * @param segments Segments to write
+ * @exception std::runtime_error if a file range can't be read
+ */
+void write_segments(std::ostream& os, const std::vector<Segment>& segments);
+
+} // namespace templet
+
+#endif // SEGMENTS_HPP
@@ -0,0 +1,420 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "ptrutil.hpp"
+#include "segments.hpp"
+#include "snapshot.hpp"
+
+using namespace templet;
+using namespace templet::types;
+
+namespace {
+
+/*
+ * Image layout. All integers are 32-bit in the byte order of the writer
+ * and all nodes start at a multiple of 4 bytes.
+ *
+ * Header:  magic[8] version byte_order root size
+ * String:  kind length bytes
+ * Integer: kind length bytes (formatted)
+ * Float:   kind length bytes (formatted)
+ * List:    kind count offset[count]
+ * Map:     kind count (key_offset value_offset)[count], sorted by key
+ *
+ * Map keys are String nodes.
+ */
+
+const char Magic[8] = {'T', 'E', 'M', 'P', 'L', 'E', 'T', 'S'};
+const std::uint32_t Version = 1;
+const std::uint32_t ByteOrder = 0x01020304;
+const std::size_t HeaderSize = sizeof(Magic) + 4 * sizeof(std::uint32_t);
+
+enum Kind : std::uint32_t {
+    KindString = 0,
+    KindInteger = 1,
+    KindFloat = 2,
+    KindList = 3,
+    KindMap = 4
+};
+
+void put_u32(std::string& out, std::uint32_t value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void set_u32(std::string& out, std::size_t offset, std::uint32_t value) {
+    std::memcpy(&out[offset], &value, sizeof(value));
+}
+
+std::uint32_t begin_node(std::string& out, Kind kind) {
+    out.append((4 - out.size() % 4) % 4, '\0');
+    if(out.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Snapshot image is too large");
+    }
+    const auto offset = static_cast<std::uint32_t>(out.size());
+    put_u32(out, kind);
+    return offset;
+}
+
+std::uint32_t write_text(std::string& out, Kind kind, const std::string& text) {
+    const auto offset = begin_node(out, kind);
+    put_u32(out, static_cast<std::uint32_t>(text.size()));
+    out += text;
+    return offset;
+}
+
+std::uint32_t write_node(std::string& out, const Data& data);
+
+std::uint32_t write_map(std::string& out, const DataMap& map) {
+    // Children are written before their parent so that the parent
+    // can be written in one go. DataMap is already sorted by key.
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> entries;
+    entries.reserve(map.size());
+    for(const auto& entry : map) {
+        const auto key = write_text(out, KindString, entry.first);
+        entries.emplace_back(key, write_node(out, *entry.second));
+    }
+    const auto offset = begin_node(out, KindMap);
+    put_u32(out, static_cast<std::uint32_t>(entries.size()));
+    for(const auto& entry : entries) {
+        put_u32(out, entry.first);
+        put_u32(out, entry.second);
+    }
+    return offset;
+}
+
+std::uint32_t write_node(std::string& out, const Data& data) {
+    switch(data.type()) {
+    case DataType::String:
+        return write_text(out, KindString, data.getValue());
+    case DataType::Integer:
+        return write_text(out, KindInteger, data.getValue());
+    case DataType::Float:
+        return write_text(out, KindFloat, data.getValue());
+    case DataType::List: {
+        std::vector<std::uint32_t> items;
+        const auto cursor = data.getCursor();
+        while(const auto item = cursor->next()) {
+            items.push_back(write_node(out, *item));
+        }
+        const auto offset = begin_node(out, KindList);
+        put_u32(out, static_cast<std::uint32_t>(items.size()));
+        for(const auto item : items) {
+            put_u32(out, item);
+        }
+        return offset;
+    }
+    case DataType::Mapper:
+        return write_map(out, data.getMap());
+    default:
+        throw std::runtime_error("Streams can't be saved in a snapshot");
+    }
+}
+
+/**
+ * @brief The Image struct is a bounds checked view of a snapshot image
+ */
+struct Image {
+    const char* data;
+    std::size_t size;
+
+    std::uint32_t u32(std::size_t offset) const {
+        if(offset > size || size - offset < sizeof(std::uint32_t)) {
+            throw std::runtime_error("Snapshot image is corrupt");
+        }
+        std::uint32_t value;
+        std::memcpy(&value, data + offset, sizeof(value));
+        return value;
+    }
+
+    const char* bytes(std::size_t offset, std::size_t length) const {
+        if(offset > size || size - offset < length) {
+            throw std::runtime_error("Snapshot image is corrupt");
+        }
+        return data + offset;
+    }
+};
+
+/**
+ * @brief The SnapshotNode class reads a node of a snapshot image
+ *
+ * The node is read from the image on every access. Only getList and
+ * getMap keep a copy, because they return references.
+ * Each copy is made once, so a node never changes after it's created
+ * and renders in different threads can share it.
+ */
+class SnapshotNode : public Data {
+private:
+    Image _image;
+    std::uint32_t _offset;
+    mutable std::once_flag _listOnce;
+    mutable DataVector _list;
+    mutable std::once_flag _mapOnce;
+    mutable DataMap _map;
+
+    Kind kind() const {
+        return static_cast<Kind>(_image.u32(_offset));
+    }
+
+    std::uint32_t count() const {
+        return _image.u32(_offset + 4);
+    }
+
+    const char* text() const {
+        return _image.bytes(_offset + 8, count());
+    }
+
+    void check(Kind expected, const char* message) const {
+        const auto actual = kind();
+        if(actual != expected
+                && !(expected == KindString && (actual == KindInteger || actual == KindFloat))) {
+            throw std::runtime_error(message);
+        }
+    }
+
+public:
+    SnapshotNode(const Image& image, std::uint32_t offset)
+        : _image(image), _offset(offset), _listOnce(), _list(), _mapOnce(), _map() {}
+
+    /**
+     * @brief Get a view of a child node
+     *
+     * The view belongs to the caller, e.g. to one render.
+     */
+    const Data* child(std::uint32_t offset, DataPtr& holder) const {
+        holder = std::make_shared<SnapshotNode>(_image, offset);
+        return holder.get();
+    }
+
+    /**
+     * @brief Find a key of a map node
+     * @param key Key to find
+     * @return Offset of the value, or 0 if the key was not found
+     */
+    std::uint32_t find(const std::string& key) const {
+        std::uint32_t first = 0;
+        std::uint32_t last = count();
+        while(first < last) {
+            const auto middle = first + (last - first) / 2;
+            const auto entry = _offset + 8 + middle * 8;
+            const auto name = _image.u32(entry);
+            const auto length = _image.u32(name + 4);
+            const auto compare = key.compare(0, std::string::npos,
+                                             _image.bytes(name + 8, length), length);
+            if(compare == 0) {
+                return _image.u32(entry + 4);
+            }
+            if(compare < 0) {
+                last = middle;
+            }
+            else {
+                first = middle + 1;
+            }
+        }
+        return 0;
+    }
+
+    bool empty() const override {
+        const auto nodeKind = kind();
+        if(nodeKind == KindInteger || nodeKind == KindFloat) {
+            return false;
+        }
+        return count() == 0;
+    }
+
+    std::string getValue() const override {
+        check(KindString, "Data item is not of type value");
+        return std::string(text(), count());
+    }
+
+    const DataVector& getList() const override {
+        check(KindList, "Data item is not of type list");
+        std::call_once(_listOnce, [this]{
+            const auto items = count();
+            DataVector list;
+            list.reserve(items);
+            for(std::uint32_t i = 0; i < items; ++i) {
+                list.push_back(std::make_shared<SnapshotNode>(_image, _image.u32(_offset + 8 + i * 4)));
+            }
+            _list.swap(list);
+        });
+        return _list;
+    }
+
+    const DataMap& getMap() const override {
+        check(KindMap, "Data item is not of type map");
+        std::call_once(_mapOnce, [this]{
+            const auto entries = count();
+            DataMap map;
+            for(std::uint32_t i = 0; i < entries; ++i) {
+                const auto entry = _offset + 8 + i * 8;
+                const SnapshotNode key(_image, _image.u32(entry));
+                map.emplace(key.getValue(), std::make_shared<SnapshotNode>(_image, _image.u32(entry + 4)));
+            }
+            _map.swap(map);
+        });
+        return _map;
+    }
+
+    const Data* getItem(std::size_t index, DataPtr& holder) const override {
+        check(KindList, "Data item is not of type list");
+        if(index >= count()) {
+            return nullptr;
+        }
+        return child(_image.u32(_offset + 8 + index * 4), holder);
+    }
+
+    const Data* getItem(const std::string& key, DataPtr& holder) const override {
+        check(KindMap, "Data item is not of type map");
+        const auto value = find(key);
+        if(value == 0) {
+            return nullptr;
+        }
+        return child(value, holder);
+    }
+
+    std::unique_ptr<DataCursor> getCursor() const override;
+
+    void write(std::ostream& os) const override {
+        check(KindString, "Data item is not of type value");
+        write_stable(os, text(), count());
+    }
+
+    DataType type() const override {
+        switch(kind()) {
+        case KindString:
+            return DataType::String;
+        case KindInteger:
+            return DataType::Integer;
+        case KindFloat:
+            return DataType::Float;
+        case KindList:
+            return DataType::List;
+        case KindMap:
+            return DataType::Mapper;
+        }
+        throw std::runtime_error("Snapshot image is corrupt");
+    }
+};
+
+/**
+ * @brief The SnapshotCursor class reads the elements of a list node
+ *
+ * Every element is a SnapshotNode created in the same storage, which
+ * belongs to the cursor, so reading a list doesn't allocate
+ */
+class SnapshotCursor : public DataCursor {
+private:
+    Image _image;
+    std::uint32_t _offset;
+    std::uint32_t _count;
+    std::uint32_t _pos;
+    mylib::InPlace<SnapshotNode> _item;
+
+public:
+    SnapshotCursor(const Image& image, std::uint32_t offset)
+        : _image(image), _offset(offset), _count(image.u32(offset + 4)), _pos(0), _item() {}
+
+    const Data* next() override {
+        if(_pos == _count) {
+            return nullptr;
+        }
+        return &_item.emplace(_image, _image.u32(_offset + 8 + _pos++ * 4));
+    }
+};
+
+std::unique_ptr<DataCursor> SnapshotNode::getCursor() const {
+    check(KindList, "Data item is not of type list");
+    return mylib::make_unique<SnapshotCursor>(_image, _offset);
+}
+
+} // unnamed namespace
+
+Snapshot::Snapshot() : _file(), _values() {
+
+}
+
+void Snapshot::load() {
+    const auto data = _file.data();
+    const auto size = _file.size();
+    if(size < HeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+        throw std::runtime_error("Not a snapshot image");
+    }
+    const Image image {data, size};
+    if(image.u32(8) != Version) {
+        throw std::runtime_error("Unsupported snapshot version");
+    }
+    if(image.u32(12) != ByteOrder) {
+        throw std::runtime_error("Snapshot image has a different byte order");
+    }
+    if(image.u32(20) != size) {
+        throw std::runtime_error("Snapshot image is truncated");
+    }
+    const SnapshotNode root(image, image.u32(16));
+    _values = root.getMap();
+}
+
+std::unique_ptr<Snapshot> Snapshot::fromFile(const std::string& path) {
+    std::unique_ptr<Snapshot> snapshot(new Snapshot);
+    snapshot->_file.open(path);
+    snapshot->load();
+    return snapshot;
+}
+
+std::unique_ptr<Snapshot> Snapshot::fromImage(std::string image) {
+    std::unique_ptr<Snapshot> snapshot(new Snapshot);
+    snapshot->_file.assign(std::move(image));
+    snapshot->load();
+    return snapshot;
+}
+
+const DataMap& Snapshot::values() const {
+    return _values;
+}
+
+std::size_t Snapshot::size() const {
+    return _file.size();
+}
+
+void templet::save_snapshot(const DataMap& values, std::ostream& os) {
+    std::string out(HeaderSize, '\0');
+    const auto root = write_map(out, values);
+    if(out.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::runtime_error("Snapshot image is too large");
+    }
+    std::memcpy(&out[0], Magic, sizeof(Magic));
+    set_u32(out, 8, Version);
+    set_u32(out, 12, ByteOrder);
+    set_u32(out, 16, root);
+    set_u32(out, 20, static_cast<std::uint32_t>(out.size()));
+    os.write(out.data(), static_cast<std::streamsize>(out.size()));
+}
@@ -0,0 +1,121 @@
+/*
+
+The MIT License (MIT)
+
+Copyright (c) 2014 https://github.com/labyrinthofdreams
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+
+*/
+
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include "mapping.hpp"
+#include "types.hpp"
+
+namespace templet {
+
+/**
+ * @brief The Snapshot class renders from a frozen binary image of a DataMap
+ *
+ * The image is position-independent: all references inside it are
+ * offsets from the start of the image. A loaded snapshot is used as
+ * render input as is, nothing is deserialised. Values are looked up
+ * from the image when a template reads them.
+ *
+ * Files are mapped read-only into memory where mmap is available, so
+ * processes that load the same file share its pages.
+ *
+ * Example usage:
+ *
+ * std::ofstream out {"catalog.snap", std::ios::binary};\n
+ * templet::save_snapshot(catalog, out);\n
+ * ...\n
+ * auto snapshot = templet::Snapshot::fromFile("catalog.snap");\n
+ * templet::parse(text, snapshot->values(), std::cout);
+ *
+ * The snapshot must outlive the renders that use its values. Images
+ * can only be loaded on machines with the same byte order.
+ */
+class Snapshot {
+private:
+    helpers::MappedFile _file;
+    DataMap _values;
+
+    Snapshot();
+
+    /**
+     * @brief Validate the image header and create the top-level values
+     * @exception std::runtime_error if the image is invalid
+     */
+    void load();
+
+public:
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+
+    /**
+     * @brief Load a snapshot from a file
+     * @param path Path to file
+     * @exception std::runtime_error if the file can't be opened or is not a valid snapshot
+     * @return Loaded snapshot
+     */
+    static std::unique_ptr<Snapshot> fromFile(const std::string& path);
+
+    /**
+     * @brief Load a snapshot from an image in memory
+     * @param image Image written by \link save_snapshot \endlink
+     * @exception std::runtime_error if the image is not a valid snapshot
+     * @return Loaded snapshot
+     */
+    static std::unique_ptr<Snapshot> fromImage(std::string image);
+
+    /**
+     * @brief Get the top-level values for rendering
+     * @return Map of values that refer to the image
+     */
+    const DataMap& values() const;
+
+    /**
+     * @brief Get the size of the image
+     * @return Size in bytes
+     */
+    std::size_t size() const;
+};
+
+/**
+ * @brief Write a binary image of values that \link Snapshot \endlink can load
+ *
+ * Strings, numbers, lists and maps are supported. Lazy values are
+ * computed, and numbers are stored formatted.
+ *
+ * @param values Values to write
+ * @param os Output, must be opened in binary mode
+ * @exception std::runtime_error if values contain a stream or the image would exceed 4 GB
+ */
+void save_snapshot(const DataMap& values, std::ostream& os);
+
+} // namespace templet
+
+#endif // SNAPSHOT_HPP
@@ -26,6 +26,7 @@ THE SOFTWARE.
 
 #include <algorithm>
 #include <memory>
+#include <sstream>
 #include <utility>
 #include "nodes.hpp"
 #include "strutils.hpp"
@@ -61,72 +62,250 @@ std::shared_ptr<Node> factory_tag_parser(const std::string& tagName, const std::
     }
 }
 
+/**
+ * @brief Check if any of the names is in a set of names
+ * @param names Names to check
+ * @param in Set of names to look from
+ * @return True if at least one name was found, otherwise false
+ */
+bool intersects(const std::set<std::string>& names, const std::set<std::string>& in) {
+    return std::any_of(names.cbegin(), names.cend(), [&in](const std::string& name){
+        return in.count(name) != 0;
+    });
 }
 
-namespace templet {
+/**
+ * @brief The Checker class checks the block structure of a template while it's tokenized
+ *
+ * Errors are reported with the line and column of the tag.
+ */
+class Checker {
+private:
+    /**
+     * @brief A block that isn't closed yet
+     */
+    struct Block {
+        NodeType type;          ///< IfValue, ElseValue after the else tag, or ForValue
+        std::size_t pos;        ///< Position of the opening tag
+        const ForValue* loop;   ///< Set for for blocks
+    };
 
-std::vector<std::shared_ptr<nodes::Node> > tokenize(std::string &in) try {
-    std::vector<std::shared_ptr<nodes::Node> > nodes;
-    while(!in.empty()) {
+    const std::string& _text;
+    std::vector<Block> _blocks;
+
+    bool inIf() const {
+        return !_blocks.empty() && _blocks.back().type == NodeType::IfValue;
+    }
+
+public:
+    explicit Checker(const std::string& text) : _text(text), _blocks() {}
+
+    /**
+     * @brief Prefix an error message with the line and column of a position
+     */
+    std::string at(std::size_t pos, const std::string& reason) const {
+        const auto line = std::count(_text.cbegin(), _text.cbegin() + pos, '\n') + 1;
+        const auto newline = pos == 0 ? std::string::npos : _text.rfind('\n', pos - 1);
+        const auto column = newline == std::string::npos ? pos + 1 : pos - newline;
+        std::ostringstream os;
+        os << "Line " << line << ", column " << column << ": " << reason;
+        return os.str();
+    }
+
+    /**
+     * @brief Throw an error at a position of the text
+     * @exception templet::exception::InvalidTagError always
+     */
+    [[noreturn]] void fail(std::size_t pos, const std::string& reason) const {
+        throw templet::exception::InvalidTagError(at(pos, reason));
+    }
+
+    /**
+     * @brief Check an if, elif, else or for tag
+     */
+    void open(Node& node, std::size_t pos) {
+        switch(node.type()) {
+        case NodeType::IfValue:
+            _blocks.push_back(Block{NodeType::IfValue, pos, nullptr});
+            break;
+        case NodeType::ElifValue:
+            if(!inIf()) {
+                fail(pos, "ELIF statements cannot be declared without a preceding IF statement");
+            }
+            break;
+        case NodeType::ElseValue:
+            if(!inIf()) {
+                fail(pos, "ELSE statements cannot be declared without a preceding IF or ELIF statement");
+            }
+            _blocks.back().type = NodeType::ElseValue;
+            break;
+        case NodeType::ForValue: {
+            auto& loop = static_cast<ForValue&>(node);
+            const bool collides = loop.path()->root() == loop.alias() ||
+                    std::any_of(_blocks.cbegin(), _blocks.cend(), [&loop](const Block& block){
+                return block.loop && block.loop->alias() == loop.alias();
+            });
+            if(collides) {
+                fail(pos, "For expression alias name collides with an existing name");
+            }
+            _blocks.push_back(Block{NodeType::ForValue, pos, &loop});
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    /**
+     * @brief Check an endif or endfor tag
+     */
+    void close(bool endif, std::size_t pos) {
+        if(_blocks.empty()) {
+            fail(pos, endif ? "ENDIF statements cannot be declared without a preceding IF statement"
+                            : "ENDFOR statements cannot be declared without a preceding FOR statement");
+        }
+        if(endif == (_blocks.back().type == NodeType::ForValue)) {
+            fail(pos, endif ? "ENDIF statements cannot close a FOR statement"
+                            : "ENDFOR statements cannot close an IF statement");
+        }
+        _blocks.pop_back();
+    }
+
+    /**
+     * @brief Check that every block is closed at the end of the text
+     */
+    void finish() const {
+        if(!_blocks.empty()) {
+            fail(_blocks.back().pos, _blocks.back().type == NodeType::ForValue
+                 ? "FOR statements must be closed with ENDFOR"
+                 : "IF statements must be closed with ENDIF");
+        }
+    }
+};
+
+/**
+ * @brief Tokenize template text until its end or the first endif or endfor
+ *
+ * Text nodes refer to ranges of the source instead of copying them.
+ *
+ * An elif or else block in an if chain becomes the last node of the block
+ * before it and takes the rest of the chain, including its endif.
+ *
+ * @param source Template text
+ * @param pos Position to start from, set to the position after the tokenized text
+ * @param chain True if tokenizing the body of an if, elif or else block
+ * @param checker If not null, checks the structure and reports errors with their location
+ * @return Vector of tokenized nodes
+ */
+std::vector<std::shared_ptr<Node>> tokenize_from(const std::shared_ptr<const std::string>& source, std::size_t& pos,
+                                                 const bool chain, Checker* checker) {
+    const std::string& in = *source;
+    std::vector<std::shared_ptr<Node>> nodes;
+    while(pos < in.size()) {
         // Parse TEXT until first TAG
-        const auto pos = in.find('{');
-        if(pos == std::string::npos) {
-           if(!in.empty()) {
-               // Plain text
-               nodes.push_back(std::make_shared<Text>(in));
-               in.clear();
-           }
-           break;
-        }
-        nodes.push_back(std::make_shared<Text>(in.substr(0, pos)));
-        in.erase(0, pos);
+        const auto start = in.find('{', pos);
+        if(start == std::string::npos) {
+            // Plain text
+            nodes.push_back(std::make_shared<Text>(source, pos, in.size() - pos));
+            pos = in.size();
+            break;
+        }
+        if(start != pos) {
+            nodes.push_back(std::make_shared<Text>(source, pos, start - pos));
+            pos = start;
+        }
 
         // Find where the tag ends
-        const auto end_pos = in.find('}');
+        const auto end_pos = in.find('}', pos);
         if(end_pos == std::string::npos) {
-           // Plain text
-           nodes.push_back(std::make_shared<Text>(in));
-           in.clear();
-           break;
+            // Plain text
+            nodes.push_back(std::make_shared<Text>(source, pos, in.size() - pos));
+            pos = in.size();
+            break;
         }
 
-        const auto tag = in.substr(0, end_pos + 1);
+        const auto tag_size = end_pos + 1 - pos;
         // Parse tag
-        if(tag[1] == '\\') {
-            // Ignored tag, remove the first \ after opening tag character
-            auto new_tag = tag.substr(2);
-            new_tag.insert(0, "{");
-            nodes.push_back(std::make_shared<Text>(new_tag));
-            in.erase(0, tag.size());
-        }
-        else if(tag[1] == '$') {
-            auto node = templet::nodes::parse_value_tag(tag);
-            in.erase(0, tag.size());
+        if(in[pos + 1] == '\\') {
+            // Ignored tag, skip the first \ after opening tag character
+            nodes.push_back(std::make_shared<Text>(source, pos, 1));
+            nodes.push_back(std::make_shared<Text>(source, pos + 2, tag_size - 2));
+            pos += tag_size;
+        }
+        else if(in[pos + 1] == '$') {
+            std::shared_ptr<Node> node;
+            try {
+                node = templet::nodes::parse_value_tag(in.substr(pos, tag_size));
+            }
+            catch(const templet::exception::InvalidTagError& ex) {
+                if(!checker) {
+                    throw;
+                }
+                checker->fail(pos, ex.what());
+            }
             nodes.push_back(std::move(node));
+            pos += tag_size;
         }
-        else if(tag[1] == '%') {
+        else if(in[pos + 1] == '%') {
+            const auto tag_pos = pos;
+            const auto tag = in.substr(pos, tag_size);
             const auto inner = mylib::ltrimmed(tag.substr(2));
-            // adding endif and endfor as nodes it would be possible
-            // to check whether an if/for node was closed properly
-            // and throw an exception if not
+            pos += tag_size;
+            // Without a checker a missing or mismatched endif or
+            // endfor is accepted, see templet::validate
             if(mylib::starts_with(inner, "endif") || mylib::starts_with(inner, "endfor")) {
-                in.erase(0, tag.size());
+                if(checker) {
+                    checker->close(mylib::starts_with(inner, "endif"), tag_pos);
+                }
                 break;
             }
-            else {
-                auto node = factory_tag_parser(inner, tag);
-                in.erase(0, tag.size());
-                node->setChildren(::tokenize(in));
-                nodes.push_back(std::move(node));
+            std::shared_ptr<Node> node;
+            try {
+                node = factory_tag_parser(inner, tag);
+            }
+            catch(const templet::exception::InvalidTagError& ex) {
+                if(!checker) {
+                    throw;
+                }
+                checker->fail(tag_pos, ex.what());
+            }
+            catch(const templet::exception::ExpressionSyntaxError& ex) {
+                if(!checker) {
+                    throw;
+                }
+                throw templet::exception::ExpressionSyntaxError(checker->at(tag_pos, ex.what()));
+            }
+            if(checker) {
+                checker->open(*node, tag_pos);
+            }
+            const auto type = node->type();
+            const bool branch = type == NodeType::ElifValue || type == NodeType::ElseValue;
+            node->setChildren(tokenize_from(source, pos, branch || type == NodeType::IfValue, checker));
+            nodes.push_back(std::move(node));
+            if(chain && branch) {
+                // The branch ended the chain
+                break;
             }
         }
         else {
-            nodes.push_back(std::make_shared<Text>(tag));
-            in.erase(0, tag.size());
+            nodes.push_back(std::make_shared<Text>(source, pos, tag_size));
+            pos += tag_size;
         }
     }
     return nodes;
 }
+
+} // unnamed namespace
+
+namespace templet {
+
+std::vector<std::shared_ptr<nodes::Node> > tokenize(std::string &in) try {
+    const auto source = std::make_shared<const std::string>(std::move(in));
+    std::size_t pos = 0;
+    auto nodes = tokenize_from(source, pos, false, nullptr);
+    in = source->substr(pos);
+    return nodes;
+}
 catch(const templet::exception::InvalidTagError& ex) {
     throw;
 }
@@ -134,10 +313,24 @@ catch(...) {
     throw;
 }
 
+std::vector<std::shared_ptr<nodes::Node>> tokenize(const std::shared_ptr<const std::string>& text) {
+    std::size_t pos = 0;
+    return tokenize_from(text, pos, false, nullptr);
+}
+
+std::vector<std::shared_ptr<nodes::Node>> validate(const std::shared_ptr<const std::string>& text) {
+    Checker checker(*text);
+    std::size_t pos = 0;
+    auto nodes = tokenize_from(text, pos, false, &checker);
+    checker.finish();
+    return nodes;
+}
+
 void parse(std::string text, const templet::DataMap &values, std::ostream& os) try {
     auto nodes = tokenize(text);
+    const Scope scope(values);
     for(const auto& node : nodes) {
-        node->evaluate(os, values);
+        node->evaluate(os, scope);
     }
 }
 catch(const templet::exception::InvalidTagError& ex) {
@@ -150,53 +343,109 @@ catch(...) {
     throw;
 }
 
+Templet::Templet()
+    : _text(std::make_shared<const std::string>()),
+      _parsed(),
+      _nodes(),
+      _keys(),
+      _segments()
+{}
+
 Templet::Templet(std::string text)
+    : _text(std::make_shared<const std::string>(std::move(text))),
+      _parsed(),
+      _nodes(),
+      _keys(),
+      _segments()
+{}
+
+Templet::Templet(std::shared_ptr<const std::string> text, std::vector<std::shared_ptr<nodes::Node>> nodes)
     : _text(std::move(text)),
       _parsed(),
-      _nodes()
+      _nodes(std::move(nodes)),
+      _keys(),
+      _segments()
 {}
 
 Templet::Templet(const Templet &other) : _text(other._text),
     _parsed(other._parsed.str()),
-    _nodes(other._nodes)
+    _nodes(other._nodes),
+    _keys(other._keys),
+    _segments(other._segments)
 {}
 
 Templet::Templet(Templet &&other) : _text(std::move(other._text)),
     _parsed(other._parsed.str()),
-    _nodes(std::move(other._nodes))
+    _nodes(std::move(other._nodes)),
+    _keys(std::move(other._keys)),
+    _segments(std::move(other._segments))
 {}
 
 Templet& Templet::operator=(const Templet &other) {
+    _text = other._text;
     _parsed.str(other._parsed.str());
     _nodes = other._nodes;
+    _keys = other._keys;
+    _segments = other._segments;
 
     return *this;
 }
 
 Templet& Templet::operator=(Templet &&other) {
+    _text = std::move(other._text);
     _parsed.str(other._parsed.str());
     _nodes = std::move(other._nodes);
+    _keys = std::move(other._keys);
+    _segments = std::move(other._segments);
 
     return *this;
 }
 
 void Templet::reset() {
     _parsed.str("");
-    _nodes.clear();
+    _segments.clear();
+}
+
+void Templet::compile() {
+    if(_nodes.empty() && _text) {
+        auto nodes = templet::tokenize(_text);
+        _nodes.swap(nodes);
+        _keys.clear();
+    }
+
+    if(_keys.size() != _nodes.size()) {
+        // Nodes given to the constructor have no keys yet
+        std::vector<std::set<std::string>> keys(_nodes.size());
+        for(std::size_t i = 0; i < _nodes.size(); ++i) {
+            _nodes[i]->collectKeys(keys[i]);
+        }
+        _keys.swap(keys);
+        nodes::runtime::memoize_paths(_nodes);
+    }
+}
+
+void Templet::validate() {
+    auto nodes = templet::validate(_text);
+    _nodes.swap(nodes);
+    _keys.clear();
+    compile();
 }
 
 void Templet::setTemplate(std::string str) {
-    _text.swap(str);
+    _text = std::make_shared<const std::string>(std::move(str));
+    _nodes.clear();
+    _keys.clear();
     reset();
 }
 
 std::string Templet::parse(const DataMap &values) {
     try {
         reset();
-        auto copied = _text;
-        _nodes = ::tokenize(copied);
+        compile();
+        const Scope scope(values);
         for(const auto& node : _nodes) {
-            node->evaluate(_parsed, values);
+            node->evaluate(_parsed, scope);
+            _segments.push_back(static_cast<std::size_t>(_parsed.tellp()));
         }
     }
     catch(const templet::exception::InvalidTagError& ex) {
@@ -212,6 +461,67 @@ std::string Templet::parse(const DataMap &values) {
     return result();
 }
 
+void Templet::render(const DataMap &values, std::ostream& os) {
+    compile();
+    const Scope scope(values);
+    for(const auto& node : _nodes) {
+        node->evaluate(os, scope);
+    }
+}
+
+ChunkRenderer Templet::chunks(const DataMap &values, std::size_t chunkSize) {
+    compile();
+    return ChunkRenderer(_nodes, values, chunkSize);
+}
+
+std::future<void> Templet::renderAsync(const DataMap &values, std::ostream& os, Executor& executor) {
+    std::unique_ptr<RenderTask> task(new RenderTask(chunks(values), os));
+    auto future = task->future();
+    executor.post(std::move(task));
+    return future;
+}
+
+std::string Templet::update(const DataMap &values,
+                            const std::set<std::string> &changed,
+                            std::vector<Change>* diff) {
+    const auto previous = result();
+    if(_segments.size() != _nodes.size() || _nodes.empty()) {
+        // Nothing to update from, parse everything
+        parse(values);
+        if(diff) {
+            diff->push_back({0, previous.size(), result()});
+        }
+        return result();
+    }
+
+    const Scope scope(values);
+    std::string output;
+    std::vector<std::size_t> segments;
+    std::size_t begin = 0;
+    for(std::size_t i = 0; i < _nodes.size(); ++i) {
+        const auto end = _segments[i];
+        if(intersects(_keys[i], changed)) {
+            std::ostringstream os;
+            _nodes[i]->evaluate(os, scope);
+            const auto text = os.str();
+            if(diff && previous.compare(begin, end - begin, text) != 0) {
+                diff->push_back({begin, end - begin, text});
+            }
+            output += text;
+        }
+        else {
+            output.append(previous, begin, end - begin);
+        }
+        segments.push_back(output.size());
+        begin = end;
+    }
+
+    _parsed.str(output);
+    _segments.swap(segments);
+
+    return result();
+}
+
 std::string Templet::result() const {
     return _parsed.str();
 }
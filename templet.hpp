@@ -27,11 +27,16 @@ THE SOFTWARE.
 #ifndef TEMPLET_HPP
 #define TEMPLET_HPP
 
+#include <cstddef>
 #include <fstream>
+#include <future>
 #include <memory>
+#include <set>
 #include <string>
 #include <sstream>
 #include <vector>
+#include "async.hpp"
+#include "chunks.hpp"
 #include "nodes.hpp"
 #include "types.hpp"
 
@@ -86,6 +91,15 @@ struct FileWriter {
 
 } // namespace helpers
 
+/**
+ * @brief A replaced byte range in previously parsed output
+ */
+struct Change {
+    std::size_t offset;  ///< Offset of the range in the previous output
+    std::size_t length;  ///< Length of the range in the previous output
+    std::string text;    ///< Text that replaces the range
+};
+
 /**
  * @brief The Templet class parses templates
  *
@@ -100,20 +114,31 @@ struct FileWriter {
  */
 class Templet {
 private:
-    std::string _text;
+    // Shared with copies and referred to by text nodes
+    std::shared_ptr<const std::string> _text;
     std::stringstream _parsed;
     std::vector<std::shared_ptr<nodes::Node>> _nodes;
+    // Top-level value names read by each node in _nodes
+    std::vector<std::set<std::string>> _keys;
+    // End offset of each node's output in _parsed
+    std::vector<std::size_t> _segments;
 
     /**
      * @brief Reset internal state
      */
     void reset();
 
+    /**
+     * @brief Tokenize the template text unless it's already tokenized
+     * @exception templet::exception::InvalidTagError if the template contains an invalid tag
+     */
+    void compile();
+
 public:
     /**
      * @brief Default empty constructor
      */
-    Templet() = default;
+    Templet();
 
     Templet(const Templet& other);
     Templet(Templet&& other);
@@ -127,6 +152,13 @@ public:
      */
     Templet(std::string text);
 
+    /**
+     * @brief Construct Templet object with template text that's already tokenized
+     * @param text Template text
+     * @param nodes Nodes of the template text
+     */
+    Templet(std::shared_ptr<const std::string> text, std::vector<std::shared_ptr<nodes::Node>> nodes);
+
     /**
      * @brief Write parsed template to file
      * @param path Path to file
@@ -148,6 +180,17 @@ public:
         setTemplate(std::move(s));
     }
 
+    /**
+     * @brief Check the structure of the template so that renders can skip the block checks
+     *
+     * See \link templet::validate \endlink. The template stays valid
+     * until it's changed with \link setTemplate \endlink.
+     *
+     * @exception templet::exception::InvalidTagError with the line and column of the first error
+     * @exception templet::exception::ExpressionSyntaxError with the line and column of an invalid for tag
+     */
+    void validate();
+
     /**
      * @brief Set template from string
      * @param str Template string
@@ -162,6 +205,63 @@ public:
      */
     std::string parse(const templet::DataMap& values);
 
+    /**
+     * @brief Parse the template and write the result to a stream
+     *
+     * The result is not kept, so memory use doesn't depend on its size.
+     * \link result \endlink and \link update \endlink are not affected.
+     *
+     * @param values Map of key-value pairs for parsing the template
+     * @param os Output stream
+     * @exception templet::exception::InvalidTagError if the template contains an invalid tag
+     */
+    void render(const templet::DataMap& values, std::ostream& os);
+
+    /**
+     * @brief Render the template a chunk at a time
+     *
+     * The renderer shares the nodes, so it stays valid if this object
+     * changes or is destroyed. The values must outlive it.
+     *
+     * @param values Map of key-value pairs for parsing the template
+     * @param chunkSize Size where a chunk is complete
+     * @exception templet::exception::InvalidTagError if the template contains an invalid tag
+     * @return Renderer that returns the output in chunks
+     */
+    ChunkRenderer chunks(const templet::DataMap& values, std::size_t chunkSize = 16384);
+
+    /**
+     * @brief Render the template on an executor
+     *
+     * The render is suspended whenever a tag reads a value that isn't
+     * ready, e.g. one made with \link make_future \endlink, so the
+     * executor can run other renders in the meantime.
+     *
+     * @param values Map of key-value pairs for parsing the template, must outlive the render
+     * @param os Output stream, must outlive the render
+     * @param executor Executor that runs the render
+     * @exception templet::exception::InvalidTagError if the template contains an invalid tag
+     * @return Future that is set when the render is complete
+     */
+    std::future<void> renderAsync(const templet::DataMap& values, std::ostream& os, Executor& executor);
+
+    /**
+     * @brief Update the previously parsed result after some values changed
+     *
+     * Only the top-level blocks that read a changed name are parsed again,
+     * the output of the other blocks is copied from the previous result.
+     * Falls back to \link parse \endlink if there's no previous result.
+     *
+     * @param values Map of key-value pairs for parsing the template
+     * @param changed Top-level names of the values that changed
+     * @param diff If not null, receives the replaced ranges of the previous result
+     * @exception templet::exception::InvalidTagError if the template contains an invalid tag
+     * @return Parsed template as a string
+     */
+    std::string update(const templet::DataMap& values,
+                       const std::set<std::string>& changed,
+                       std::vector<Change>* diff = nullptr);
+
     /**
      * @brief result
      * @return Parsed template as a string
@@ -178,6 +278,35 @@ public:
  */
 std::vector<std::shared_ptr<nodes::Node>> tokenize(std::string &in);
 
+/**
+ * @brief Tokenize template text into a vector of nodes
+ *
+ * Text nodes refer to ranges of the text and share its ownership.
+ *
+ * @param text Template text
+ * @exception templet::exception::InvalidTagError if the template contains an invalid tag
+ * @return Vector of tokenized nodes
+ */
+std::vector<std::shared_ptr<nodes::Node>> tokenize(const std::shared_ptr<const std::string>& text);
+
+/**
+ * @brief Tokenize template text and check its structure
+ *
+ * \link tokenize \endlink accepts a missing or mismatched endif or
+ * endfor, and a misplaced elif or else or a for alias that collides
+ * with another name is only reported when the block is rendered.
+ * Here they're errors, and so are tags that fail to parse, with the
+ * line and column of the tag. A for alias that collides with a value
+ * is still an error when the block is rendered, the same as without
+ * validation, because the values aren't known here.
+ *
+ * @param text Template text
+ * @exception templet::exception::InvalidTagError with the line and column of the first error
+ * @exception templet::exception::ExpressionSyntaxError with the line and column of an invalid for tag
+ * @return Vector of tokenized nodes
+ */
+std::vector<std::shared_ptr<nodes::Node>> validate(const std::shared_ptr<const std::string>& text);
+
 
 /**
  * @brief Parse a string with some values
@@ -0,0 +1,517 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "async.hpp"
+#include "batch.hpp"
+#include "bind.hpp"
+#include "builder.hpp"
+#include "compiled.hpp"
+#include "csv.hpp"
+#include "file.hpp"
+#include "json.hpp"
+#include "literal.hpp"
+#include "segments.hpp"
+#include "snapshot.hpp"
+#include "templet.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define BENCH_WRITEV
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+//
+// Allocation counting
+//
+
+// Generated by templetc into compiled_templates.cpp
+void render_rows(std::ostream& os, const templet::DataMap& values);
+
+namespace {
+
+struct Row {
+    std::string name;
+    std::string ip;
+};
+
+} // unnamed namespace
+
+namespace templet {
+
+template <>
+struct Binding<Row> {
+    static void fields(binding::Fields<Row>& f) {
+        f("name", &Row::name)("ip", &Row::ip);
+    }
+};
+
+} // namespace templet
+
+namespace {
+
+std::size_t allocations = 0;
+std::size_t allocated_bytes = 0;
+
+} // unnamed namespace
+
+void* operator new(std::size_t size) {
+    ++allocations;
+    allocated_bytes += size;
+    if(void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return ::operator new(size);
+    }
+    catch(const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return ::operator new(size, std::nothrow);
+}
+
+// Every delete goes through this one, so it frees exactly what the
+// replaced new allocates. GCC inlines it next to calls of new that it
+// doesn't inline and then warns that free doesn't match new
+#if defined(__GNUC__)
+__attribute__((noinline))
+#endif
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    ::operator delete(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    ::operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    ::operator delete(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    ::operator delete(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    ::operator delete(p);
+}
+
+namespace {
+
+/**
+ * @brief Run a benchmark case and print its time and allocations
+ * @param name Name of the case
+ * @param fn Case to run
+ */
+void run(const char* name, const std::function<void()>& fn) {
+    const auto allocationsBefore = allocations;
+    const auto bytesBefore = allocated_bytes;
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    std::printf("%-40s %8lld ms %10zu allocs %12zu bytes\n", name, static_cast<long long>(ms),
+                allocations - allocationsBefore, allocated_bytes - bytesBefore);
+}
+
+const std::size_t ListSize = 1000000;
+
+std::vector<std::string> make_strings() {
+    std::vector<std::string> xs;
+    xs.reserve(ListSize);
+    for(std::size_t i = 0; i < ListSize; ++i) {
+        xs.push_back("user-name-number-" + std::to_string(i));
+    }
+    return xs;
+}
+
+/**
+ * @brief Create distinct page templates of about 1 KB each
+ * @param count Number of templates
+ * @return Pairs of template name and template text
+ */
+std::vector<std::pair<std::string, std::string>> make_templates(std::size_t count) {
+    std::vector<std::pair<std::string, std::string>> templates;
+    templates.reserve(count);
+    for(std::size_t i = 0; i < count; ++i) {
+        const auto id = std::to_string(i);
+        std::string text = "<html><head><title>{$ page.title } " + id + "</title></head><body>\n";
+        text += "{% if user %}<p>Signed in as {$ user.name }</p>{% else %}<p>Sign in</p>{% endif %}\n";
+        for(int section = 0; section < 4; ++section) {
+            text += "<h2>{$ sections[" + std::to_string(section) + "].title }</h2>\n<ul>\n";
+            text += "{% for sections[" + std::to_string(section) + "].items as item %}"
+                    "<li><a href=\"{$ item.url }\">{$ item.label }</a>{% if item.badge %} <b>{$ item.badge }</b>{% endif %}</li>\n"
+                    "{% endfor %}</ul>\n";
+        }
+        text += "<footer>Page " + id + "</footer></body></html>\n";
+        templates.emplace_back("page" + id, std::move(text));
+    }
+    return templates;
+}
+
+} // unnamed namespace
+
+int main() {
+    const auto strings = make_strings();
+
+    templet::DataMap map;
+    run("build data list", [&]{
+        map["items"] = templet::make_data(strings);
+    });
+
+    run("build string list", [&]{
+        map["items"] = templet::make_string_list(strings);
+    });
+
+    templet::Templet tpl("{% for items as item %}{$ item }{% endfor %}");
+    run("render string list", [&]{
+        tpl.parse(map);
+    });
+
+    templet::DataMap rows;
+    run("build map rows", [&]{
+        templet::DataVector xs;
+        xs.reserve(ListSize);
+        for(std::size_t i = 0; i < ListSize; ++i) {
+            templet::DataMap row;
+            row["name"] = templet::make_data(strings[i]);
+            row["ip"] = templet::make_data("192.168.101.1");
+            xs.push_back(templet::make_data(std::move(row)));
+        }
+        rows["rows"] = templet::make_data(std::move(xs));
+    });
+
+    templet::Templet rowTpl("{% for rows as row %}{$ row.name }{$ row.ip }{% endfor %}");
+    run("render map rows", [&]{
+        rowTpl.parse(rows);
+    });
+
+    run("render map rows with templetc", [&]{
+        std::ostringstream os;
+        render_rows(os, rows);
+    });
+
+    run("render map rows in 16 KB chunks", [&]{
+        auto chunks = rowTpl.chunks(rows);
+        std::string chunk;
+        while(chunks.next(chunk)) {
+        }
+    });
+
+    run("render map rows with renderAsync", [&]{
+        std::ostringstream os;
+        templet::LocalExecutor executor;
+        auto render = rowTpl.renderAsync(rows, os, executor);
+        executor.run();
+        render.get();
+    });
+
+    rows["site"] = templet::make_data(templet::DataMap{
+        {"theme", templet::make_data("dark")},
+        {"columns", templet::make_data({"Name", "Address"})}
+    });
+    templet::Templet invariantTpl("{% for rows as row %}<tr class=\"{$ site.theme }\">"
+                                  "{% for site.columns as c %}<th>{$ c }</th>{% endfor %}"
+                                  "<td>{$ row.name }</td></tr>{% endfor %}");
+    run("render map rows with loop-invariant tags", [&]{
+        invariantTpl.parse(rows);
+    });
+
+    templet::Templet branchTpl("{% for rows as row %}{% if row.admin %}A{% elif row.guest %}G"
+                               "{% elif row.ip %}{$ row.ip }{% else %}-{% endif %}{% endfor %}");
+    run("render map rows with if-elif chains", [&]{
+        branchTpl.parse(rows);
+    });
+
+    rows["user"] = templet::make_data(templet::DataMap{
+        {"profile", templet::make_data(templet::DataMap{{"display_name", templet::make_data("John Doe")}})}
+    });
+    templet::Templet repeatedTpl("{% for rows as row %}<tr title=\"{$ user.profile.display_name }\">"
+                                 "<td>{$ row.name }</td><td>{$ user.profile.display_name }</td>"
+                                 "<td>{$ row.name }</td></tr>{% endfor %}");
+    run("render map rows with repeated paths", [&]{
+        repeatedTpl.parse(rows);
+    });
+
+    run("destroy map rows", [&]{
+        rows.clear();
+    });
+
+    std::vector<Row> structs;
+    structs.reserve(ListSize);
+    for(std::size_t i = 0; i < ListSize; ++i) {
+        structs.push_back(Row{strings[i], "192.168.101.1"});
+    }
+    run("bind struct rows", [&]{
+        rows["rows"] = templet::make_binding(structs);
+    });
+
+    run("render struct rows", [&]{
+        rowTpl.parse(rows);
+    });
+    rows.clear();
+
+    std::string jsonText = "{\"rows\": [";
+    for(std::size_t i = 0; i < ListSize; ++i) {
+        jsonText += (i ? ",{\"name\": \"" : "{\"name\": \"") + strings[i] + "\", \"ip\": \"192.168.101.1\"}";
+    }
+    jsonText += "]}";
+    std::unique_ptr<templet::JsonDocument> json;
+    run("parse json rows", [&]{
+        json = templet::JsonDocument::parse(jsonText);
+    });
+
+    run("render json rows", [&]{
+        rowTpl.parse(json->values());
+    });
+
+    run("destroy json rows", [&]{
+        json.reset();
+    });
+
+    std::string csvText = "name,ip\n";
+    std::string ndjsonText;
+    for(std::size_t i = 0; i < ListSize; ++i) {
+        csvText += strings[i] + ",192.168.101.1\n";
+        ndjsonText += "{\"name\": \"" + strings[i] + "\", \"ip\": \"192.168.101.1\"}\n";
+    }
+    std::ofstream discard;
+    templet::DataMap streams;
+    streams["rows"] = templet::make_csv_stream([&]{
+        return std::unique_ptr<std::istream>(new std::istringstream(csvText));
+    });
+    run("render csv rows to stream", [&]{
+        rowTpl.render(streams, discard);
+    });
+
+    streams["rows"] = templet::make_ndjson_stream([&]{
+        return std::unique_ptr<std::istream>(new std::istringstream(ndjsonText));
+    });
+    run("render ndjson rows to stream", [&]{
+        rowTpl.render(streams, discard);
+    });
+
+    run("build map rows with DataBuilder", [&]{
+        templet::DataBuilder builder;
+        templet::DataVector xs;
+        xs.reserve(ListSize);
+        for(std::size_t i = 0; i < ListSize; ++i) {
+            templet::DataMap row;
+            row["name"] = builder.make(strings[i]);
+            row["ip"] = builder.make("192.168.101.1");
+            xs.push_back(builder.make(std::move(row)));
+        }
+        rows["rows"] = builder.make(std::move(xs));
+    });
+
+    run("render map rows with DataBuilder", [&]{
+        rowTpl.parse(rows);
+    });
+
+    run("destroy map rows with DataBuilder", [&]{
+        rows.clear();
+    });
+
+    templet::DataMap table;
+    run("build table rows", [&]{
+        std::vector<std::vector<std::string>> xs;
+        xs.reserve(ListSize);
+        for(std::size_t i = 0; i < ListSize; ++i) {
+            xs.push_back({strings[i], "192.168.101.1"});
+        }
+        table["rows"] = templet::make_table({"name", "ip"}, std::move(xs));
+    });
+
+    run("render table rows", [&]{
+        rowTpl.parse(table);
+    });
+
+    std::ostringstream image;
+    templet::save_snapshot(table, image);
+    const auto imageText = image.str();
+    std::unique_ptr<templet::Snapshot> snapshot;
+    run("load snapshot rows", [&]{
+        snapshot = templet::Snapshot::fromImage(imageText);
+    });
+
+    run("render snapshot rows", [&]{
+        rowTpl.parse(snapshot->values());
+    });
+
+    const std::size_t Templates = 100000;
+    run("tokenize template text", [&]{
+        for(std::size_t i = 0; i < Templates; ++i) {
+            std::string text("{% for servers as s %}{$ s.name } {$ s.load }:{% for s.tags as tag %}{$ tag }{% endfor %};{% endfor %}");
+            templet::tokenize(text);
+        }
+    });
+
+    run("create nodes from literal template", [&]{
+        for(std::size_t i = 0; i < Templates; ++i) {
+            TEMPLET_LITERAL("{% for servers as s %}{$ s.name } {$ s.load }:{% for s.tags as tag %}{$ tag }{% endfor %};{% endfor %}");
+        }
+    });
+
+#ifdef BENCH_WRITEV
+    templet::DataMap articles;
+    {
+        templet::DataVector xs;
+        const std::string body(300, 'b');
+        for(std::size_t i = 0; i < ListSize / 10; ++i) {
+            templet::DataMap article;
+            article["title"] = templet::make_data(strings[i]);
+            article["body"] = templet::make_data(body);
+            xs.push_back(templet::make_data(std::move(article)));
+        }
+        articles["articles"] = templet::make_data(std::move(xs));
+    }
+    templet::Templet articleTpl("{% for articles as a %}<article class=\"post\">\n"
+                                "  <header><h2 class=\"post-title\">{$ a.title }</h2></header>\n"
+                                "  <div class=\"post-body\">{$ a.body }</div>\n"
+                                "  <footer><a class=\"more\" href=\"#\">Read more</a></footer>\n"
+                                "</article>\n{% endfor %}");
+    const int devnull = ::open("/dev/null", O_WRONLY);
+    run("render articles and write", [&]{
+        std::ostringstream os;
+        articleTpl.render(articles, os);
+        const auto text = os.str();
+        if(::write(devnull, text.data(), text.size()) < 0) {
+            std::perror("write");
+        }
+    });
+
+    run("render articles to segments and writev", [&]{
+        templet::SegmentStream os;
+        articleTpl.render(articles, os);
+        templet::write_segments(devnull, os.segments());
+    });
+
+    {
+        std::ofstream out {"bench_blob.bin", std::ios::binary};
+        out << std::string(4 << 20, 'x');
+    }
+    templet::DataMap blobs;
+    templet::DataMap fileBlobs;
+    {
+        templet::DataVector xs;
+        templet::DataVector files;
+        const auto blob = templet::helpers::FileReader::fromFile("bench_blob.bin");
+        for(int i = 0; i < 50; ++i) {
+            xs.push_back(templet::make_data(blob));
+            files.push_back(templet::make_file_data("bench_blob.bin"));
+        }
+        blobs["blobs"] = templet::make_data(std::move(xs));
+        fileBlobs["blobs"] = templet::make_data(std::move(files));
+    }
+    templet::Templet blobTpl("{% for blobs as blob %}<section>{$ blob }</section>\n{% endfor %}");
+    run("render 50 4 MB strings and write", [&]{
+        std::ostringstream os;
+        blobTpl.render(blobs, os);
+        const auto text = os.str();
+        if(::write(devnull, text.data(), text.size()) < 0) {
+            std::perror("write");
+        }
+    });
+
+    run("render 50 4 MB files to segments and send", [&]{
+        templet::SegmentStream os;
+        blobTpl.render(fileBlobs, os);
+        templet::write_segments(devnull, os.segments());
+    });
+    std::remove("bench_blob.bin");
+    ::close(devnull);
+#endif
+
+    templet::DataMap page;
+    {
+        templet::DataVector xs;
+        for(std::size_t i = 0; i < 20; ++i) {
+            templet::DataMap article;
+            article["title"] = templet::make_data(strings[i]);
+            xs.push_back(templet::make_data(std::move(article)));
+        }
+        page["articles"] = templet::make_data(std::move(xs));
+    }
+    templet::Templet pageTpl("<html><body>{% for articles as a %}<h2>{$ a.title }</h2>{% endfor %}</body></html>");
+    const auto pagePath = [](int i) {
+        return "bench_page_" + std::to_string(i) + ".html";
+    };
+    run("render 2000 files and write each", [&]{
+        for(int i = 0; i < 2000; ++i) {
+            templet::helpers::FileWriter::toFile(pagePath(i), pageTpl.parse(page));
+        }
+    });
+
+    run("render 2000 files and write in a batch", [&]{
+        templet::helpers::BatchWriter writer;
+        for(int i = 0; i < 2000; ++i) {
+            writer.write(pagePath(i), pageTpl.parse(page));
+        }
+        writer.finish();
+    });
+    for(int i = 0; i < 2000; ++i) {
+        std::remove(pagePath(i).c_str());
+    }
+
+    const auto pages = make_templates(2000);
+    run("load 2000 templates from source", [&]{
+        std::vector<templet::Templet> loaded;
+        loaded.reserve(pages.size());
+        for(const auto& page : pages) {
+            const auto text = std::make_shared<const std::string>(page.second);
+            loaded.emplace_back(text, templet::tokenize(text));
+        }
+    });
+
+    {
+        std::ofstream out {"bench_templates.bin", std::ios::binary};
+        templet::save_compiled(pages, out);
+    }
+    run("load 2000 templates from binary cache", [&]{
+        const auto compiled = templet::CompiledTemplates::fromFile("bench_templates.bin");
+        std::vector<templet::Templet> loaded;
+        loaded.reserve(pages.size());
+        for(const auto& page : pages) {
+            loaded.push_back(compiled->get(page.first, page.second));
+        }
+    });
+    std::remove("bench_templates.bin");
+
+    templet::DataMap numbers;
+    run("build integer list", [&]{
+        templet::DataVector xs;
+        xs.reserve(ListSize);
+        for(std::size_t i = 0; i < ListSize; ++i) {
+            xs.push_back(templet::make_data(i * 1000003));
+        }
+        numbers["items"] = templet::make_data(std::move(xs));
+    });
+
+    run("render integer list", [&]{
+        tpl.parse(numbers);
+    });
+
+    return 0;
+}
@@ -0,0 +1,1609 @@
+// Generated by templetc, do not edit
+
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "nodes.hpp"
+
+namespace {
+
+const std::string name0 = "debug";
+const std::string name1 = "test";
+const std::string name2 = "gravity";
+const std::string name3 = "first_name";
+const std::string name4 = "last_name";
+const std::string name5 = "user";
+const std::string name6 = "users";
+const std::string name7 = "s";
+const std::string name8 = "servers";
+const std::string name9 = "s.name";
+const std::string name10 = "s.load";
+const std::string name11 = "tag";
+const std::string name12 = "s.tags";
+const std::string name13 = "items[0]";
+const std::string name14 = "items[1]";
+const std::string name15 = "items[2]";
+const std::string name16 = "items[00]";
+const std::string name17 = "items[01]";
+const std::string name18 = "items[02]";
+const std::string name19 = "items[[0]]";
+const std::string name20 = "items[0";
+const std::string name21 = "items[x]";
+const std::string name22 = "items[]";
+const std::string name23 = "items[1.56]";
+const std::string name24 = "items[0x01]";
+const std::string name25 = "items[3]";
+const std::string name26 = "items[-1]";
+const std::string name27 = "items[0][0]";
+const std::string name28 = "item[0]";
+const std::string name29 = "s.id";
+const std::string name30 = "s.online";
+const std::string name31 = "s.location.city";
+const std::string name32 = "s.location.latitude";
+const std::string name33 = "port";
+const std::string name34 = "s.ports";
+const std::string name35 = "first.traffic";
+const std::string name36 = "row";
+const std::string name37 = "rows";
+const std::string name38 = "row.name";
+const std::string name39 = "row.city";
+const std::string name40 = "row.a";
+const std::string name41 = "row.b";
+const std::string name42 = "name";
+const std::string name43 = "names";
+const std::string name44 = "max";
+const std::string name45 = "fits";
+const std::string name46 = "config.hostname";
+const std::string name47 = "server.ips[1]";
+const std::string name48 = "server.[1]";
+const std::string name49 = ".server.ips[1]";
+const std::string name50 = "config.server";
+const std::string name51 = "config.server.ip";
+const std::string name52 = "config.servers[1].ips[1]";
+const std::string name53 = "config.servers[1].hostname";
+const std::string name54 = "config.server[1].hostname[1]";
+const std::string name55 = "config.servers[1].hostname[1]";
+const std::string name56 = "config.servers.hostname[1]";
+const std::string name57 = "config.servers[0]ips[1]";
+const std::string name58 = "_users";
+const std::string name59 = "users[0]";
+const std::string name60 = "groups[0][1]";
+const std::string name61 = "groups[0]";
+const std::string name62 = "user[0]";
+const std::string name63 = "users.active";
+const std::string name64 = "server";
+const std::string name65 = "server.users";
+const std::string name66 = "server.ip";
+const std::string name67 = "server.name";
+const std::string name68 = "n";
+const std::string name69 = "numbers";
+const std::string name70 = "m";
+const std::string name71 = "x";
+const std::string name72 = "y";
+const std::string name73 = "x.name";
+const std::string name74 = "y.name";
+const std::string name75 = "is_world";
+const std::string name76 = "config.server.hostname";
+const std::string name77 = "config.servers[0].hostname";
+const std::string name78 = "config.servers[0].hostnames[0]";
+const std::string name79 = "config.servers[0].hostnames[2]";
+const std::string name80 = "mode";
+const std::string name81 = "modes";
+const std::string name82 = "azAZ09_-";
+const std::string name83 = "config..hostname";
+const std::string name84 = "config...hostname";
+const std::string name85 = "a.b[3].c";
+const std::string name86 = "a.b[0]";
+const std::string name87 = "a.b[2]";
+const std::string name88 = "a.b[4]";
+const std::string name89 = "obj.n";
+const std::string name90 = "obj.f";
+const std::string name91 = "obj.t";
+const std::string name92 = "obj.z";
+const std::string name93 = "arr[0]";
+const std::string name94 = "arr[1]";
+const std::string name95 = "arr[2]";
+const std::string name96 = "arr[3]";
+const std::string name97 = "item";
+const std::string name98 = "arr";
+const std::string name99 = "title";
+const std::string name100 = "owner.name";
+const std::string name101 = "owner.city";
+const std::string name102 = "enabled";
+const std::string name103 = "disabled";
+const std::string name104 = "missing";
+const std::string name105 = "tags";
+const std::string name106 = "count";
+const std::string name107 = "show";
+const std::string name108 = "report";
+const std::string name109 = "items[0][1]";
+const std::string name110 = "items[1][1]";
+const std::string name111 = "site.name";
+const std::string name112 = "row.admin";
+const std::string name113 = "row.tags";
+const std::string name114 = "price";
+const std::string name115 = "size";
+const std::string name116 = "sizes";
+const std::string name117 = "user.name";
+const std::string name118 = "items";
+const std::string name119 = "item.id";
+const std::string name120 = "user.missing";
+const std::string name121 = "empty";
+const std::string name122 = "numbers[0]";
+const std::string name123 = "servers[1].name";
+const std::string name124 = "servers[2].name";
+const std::string name125 = "servers[0].port";
+const std::string name126 = "is_not_test";
+const std::string name127 = "azAZ09-_";
+const std::string name128 = "a";
+const std::string name129 = "admin";
+const std::string name130 = "row.ip";
+
+const templet::nodes::Path path0(name0);
+const templet::nodes::Path path1(name1);
+const templet::nodes::Path path2(name2);
+const templet::nodes::Path path3(name3);
+const templet::nodes::Path path4(name4);
+const templet::nodes::Path path5(name5);
+const templet::nodes::Path path6(name6);
+const templet::nodes::Path path8(name8);
+const templet::nodes::Path path9(name9);
+const templet::nodes::Path path10(name10);
+const templet::nodes::Path path11(name11);
+const templet::nodes::Path path12(name12);
+const templet::nodes::Path path13(name13);
+const templet::nodes::Path path14(name14);
+const templet::nodes::Path path15(name15);
+const templet::nodes::Path path16(name16);
+const templet::nodes::Path path17(name17);
+const templet::nodes::Path path18(name18);
+const templet::nodes::Path path19(name19);
+const templet::nodes::Path path20(name20);
+const templet::nodes::Path path21(name21);
+const templet::nodes::Path path22(name22);
+const templet::nodes::Path path23(name23);
+const templet::nodes::Path path24(name24);
+const templet::nodes::Path path25(name25);
+const templet::nodes::Path path26(name26);
+const templet::nodes::Path path27(name27);
+const templet::nodes::Path path28(name28);
+const templet::nodes::Path path29(name29);
+const templet::nodes::Path path30(name30);
+const templet::nodes::Path path31(name31);
+const templet::nodes::Path path32(name32);
+const templet::nodes::Path path33(name33);
+const templet::nodes::Path path34(name34);
+const templet::nodes::Path path35(name35);
+const templet::nodes::Path path37(name37);
+const templet::nodes::Path path38(name38);
+const templet::nodes::Path path39(name39);
+const templet::nodes::Path path40(name40);
+const templet::nodes::Path path41(name41);
+const templet::nodes::Path path42(name42);
+const templet::nodes::Path path43(name43);
+const templet::nodes::Path path44(name44);
+const templet::nodes::Path path45(name45);
+const templet::nodes::Path path46(name46);
+const templet::nodes::Path path47(name47);
+const templet::nodes::Path path48(name48);
+const templet::nodes::Path path49(name49);
+const templet::nodes::Path path50(name50);
+const templet::nodes::Path path51(name51);
+const templet::nodes::Path path52(name52);
+const templet::nodes::Path path53(name53);
+const templet::nodes::Path path54(name54);
+const templet::nodes::Path path55(name55);
+const templet::nodes::Path path56(name56);
+const templet::nodes::Path path57(name57);
+const templet::nodes::Path path58(name58);
+const templet::nodes::Path path59(name59);
+const templet::nodes::Path path60(name60);
+const templet::nodes::Path path61(name61);
+const templet::nodes::Path path62(name62);
+const templet::nodes::Path path63(name63);
+const templet::nodes::Path path65(name65);
+const templet::nodes::Path path66(name66);
+const templet::nodes::Path path67(name67);
+const templet::nodes::Path path68(name68);
+const templet::nodes::Path path69(name69);
+const templet::nodes::Path path70(name70);
+const templet::nodes::Path path73(name73);
+const templet::nodes::Path path74(name74);
+const templet::nodes::Path path75(name75);
+const templet::nodes::Path path76(name76);
+const templet::nodes::Path path77(name77);
+const templet::nodes::Path path78(name78);
+const templet::nodes::Path path79(name79);
+const templet::nodes::Path path80(name80);
+const templet::nodes::Path path81(name81);
+const templet::nodes::Path path82(name82);
+const templet::nodes::Path path83(name83);
+const templet::nodes::Path path84(name84);
+const templet::nodes::Path path85(name85);
+const templet::nodes::Path path86(name86);
+const templet::nodes::Path path87(name87);
+const templet::nodes::Path path88(name88);
+const templet::nodes::Path path89(name89);
+const templet::nodes::Path path90(name90);
+const templet::nodes::Path path91(name91);
+const templet::nodes::Path path92(name92);
+const templet::nodes::Path path93(name93);
+const templet::nodes::Path path94(name94);
+const templet::nodes::Path path95(name95);
+const templet::nodes::Path path96(name96);
+const templet::nodes::Path path97(name97);
+const templet::nodes::Path path98(name98);
+const templet::nodes::Path path99(name99);
+const templet::nodes::Path path100(name100);
+const templet::nodes::Path path101(name101);
+const templet::nodes::Path path102(name102);
+const templet::nodes::Path path103(name103);
+const templet::nodes::Path path104(name104);
+const templet::nodes::Path path105(name105);
+const templet::nodes::Path path106(name106);
+const templet::nodes::Path path107(name107);
+const templet::nodes::Path path108(name108);
+const templet::nodes::Path path109(name109);
+const templet::nodes::Path path110(name110);
+const templet::nodes::Path path111(name111);
+const templet::nodes::Path path112(name112);
+const templet::nodes::Path path113(name113);
+const templet::nodes::Path path114(name114);
+const templet::nodes::Path path115(name115);
+const templet::nodes::Path path116(name116);
+const templet::nodes::Path path117(name117);
+const templet::nodes::Path path118(name118);
+const templet::nodes::Path path119(name119);
+const templet::nodes::Path path120(name120);
+const templet::nodes::Path path121(name121);
+const templet::nodes::Path path122(name122);
+const templet::nodes::Path path123(name123);
+const templet::nodes::Path path124(name124);
+const templet::nodes::Path path125(name125);
+const templet::nodes::Path path126(name126);
+const templet::nodes::Path path127(name127);
+const templet::nodes::Path path128(name128);
+const templet::nodes::Path path129(name129);
+const templet::nodes::Path path130(name130);
+
+} // unnamed namespace
+
+void render_branches(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path0, scope0)) {
+        os.write("Debug mode", 10);
+    }
+    else {
+        if(templet::nodes::runtime::is_set(path1, scope0)) {
+            os.write("Test mode", 9);
+        }
+        else {
+            if(templet::nodes::runtime::is_set(path2, scope0)) {
+                os.write("Gravity mode", 12);
+            }
+            else {
+                os.write("Release mode", 12);
+            }
+        }
+    }
+    os.write("\n", 1);
+}
+
+void render_escapes(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello {world} {world} {$world} {*world} \"quoted\"\?\? \t", 52);
+    templet::nodes::runtime::write_value(os, path3, scope0);
+    os.write("\n", 1);
+}
+
+void render_hello(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello, ", 7);
+    templet::nodes::runtime::write_value(os, path3, scope0);
+    os.write(" ", 1);
+    templet::nodes::runtime::write_value(os, path4, scope0);
+    os.write("\n", 1);
+}
+
+void render_loops(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path6, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            templet::nodes::runtime::write_value(os, path5, scope1);
+            os.write(",", 1);
+        }
+    }
+    os.write("\n", 1);
+    {
+        std::vector<templet::types::DataPtr> keep2;
+        bool stable2 = true;
+        const auto cursor2 = templet::nodes::runtime::open_cursor(path8, name7, scope0, keep2, &stable2);
+        while(const auto item2 = cursor2->next()) {
+            const templet::nodes::Scope scope2(scope0, name7, item2, stable2);
+            templet::nodes::runtime::write_value(os, path9, scope2);
+            os.write(" ", 1);
+            templet::nodes::runtime::write_value(os, path10, scope2);
+            os.write(":", 1);
+            {
+                std::vector<templet::types::DataPtr> keep3;
+                bool stable3 = true;
+                const auto cursor3 = templet::nodes::runtime::open_cursor(path12, name11, scope2, keep3, &stable3);
+                while(const auto item3 = cursor3->next()) {
+                    const templet::nodes::Scope scope3(scope2, name11, item3, stable3);
+                    templet::nodes::runtime::write_value(os, path11, scope3);
+                }
+            }
+            os.write(";", 1);
+        }
+    }
+    os.write("\n", 1);
+}
+
+void render_misplaced(std::ostream& /*os*/, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    throw templet::exception::InvalidTagError("ELSE statements cannot be declared without a preceding IF or ELIF statement");
+}
+
+void render_nested_branches(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path0, scope0)) {
+        os.write("Debug mode", 10);
+    }
+    else {
+        if(templet::nodes::runtime::is_set(path1, scope0)) {
+            os.write("Test mode", 9);
+        }
+        else {
+            os.write("Release mode", 12);
+            if(templet::nodes::runtime::is_set(path2, scope0)) {
+                os.write("Gravity", 7);
+            }
+        }
+    }
+    os.write("\n", 1);
+}
+
+void render_parser_array_access(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Items in a list: ", 17);
+    templet::nodes::runtime::write_value(os, path13, scope0);
+    os.write(", ", 2);
+    templet::nodes::runtime::write_value(os, path14, scope0);
+    os.write(", ", 2);
+    templet::nodes::runtime::write_value(os, path15, scope0);
+}
+
+void render_parser_array_access_ignore_leading_zero(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Items in a list: ", 17);
+    templet::nodes::runtime::write_value(os, path16, scope0);
+    os.write(", ", 2);
+    templet::nodes::runtime::write_value(os, path17, scope0);
+    os.write(", ", 2);
+    templet::nodes::runtime::write_value(os, path18, scope0);
+}
+
+void render_parser_array_access_invalid_format(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Items in a list: ", 17);
+    templet::nodes::runtime::write_value(os, path19, scope0);
+}
+
+void render_parser_array_access_invalid_format_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Items in a list: ", 17);
+    templet::nodes::runtime::write_value(os, path20, scope0);
+}
+
+void render_parser_array_access_invalid_format_3(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Items in a list: ", 17);
+    templet::nodes::runtime::write_value(os, path21, scope0);
+}
+
+void render_parser_array_access_invalid_format_4(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Items in a list: ", 17);
+    templet::nodes::runtime::write_value(os, path22, scope0);
+}
+
+void render_parser_array_access_invalid_numbers(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Value: ", 7);
+    templet::nodes::runtime::write_value(os, path23, scope0);
+}
+
+void render_parser_array_access_invalid_numbers_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Value: ", 7);
+    templet::nodes::runtime::write_value(os, path24, scope0);
+}
+
+void render_parser_array_access_out_of_range(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Items in a list: ", 17);
+    templet::nodes::runtime::write_value(os, path25, scope0);
+}
+
+void render_parser_array_access_out_of_range_negative(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Items in a list: ", 17);
+    templet::nodes::runtime::write_value(os, path26, scope0);
+}
+
+void render_parser_array_access_string(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path27, scope0);
+}
+
+void render_parser_array_access_string_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path28, scope0);
+}
+
+void render_parser_bind_struct(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path8, name7, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name7, item1, stable1);
+            templet::nodes::runtime::write_value(os, path9, scope1);
+            os.write("#", 1);
+            templet::nodes::runtime::write_value(os, path29, scope1);
+            if(templet::nodes::runtime::is_set(path30, scope1)) {
+                os.write("*", 1);
+            }
+            os.write(" ", 1);
+            templet::nodes::runtime::write_value(os, path31, scope1);
+            os.write("@", 1);
+            templet::nodes::runtime::write_value(os, path32, scope1);
+            os.write(":", 1);
+            {
+                std::vector<templet::types::DataPtr> keep2;
+                bool stable2 = true;
+                const auto cursor2 = templet::nodes::runtime::open_cursor(path12, name11, scope1, keep2, &stable2);
+                while(const auto item2 = cursor2->next()) {
+                    const templet::nodes::Scope scope2(scope1, name11, item2, stable2);
+                    templet::nodes::runtime::write_value(os, path11, scope2);
+                    os.write(",", 1);
+                }
+            }
+            {
+                std::vector<templet::types::DataPtr> keep3;
+                bool stable3 = true;
+                const auto cursor3 = templet::nodes::runtime::open_cursor(path34, name33, scope1, keep3, &stable3);
+                while(const auto item3 = cursor3->next()) {
+                    const templet::nodes::Scope scope3(scope1, name33, item3, stable3);
+                    templet::nodes::runtime::write_value(os, path33, scope3);
+                    os.write(",", 1);
+                }
+            }
+            os.write("|", 1);
+        }
+    }
+    templet::nodes::runtime::write_value(os, path35, scope0);
+}
+
+void render_parser_csv_stream(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path37, name36, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name36, item1, stable1);
+            templet::nodes::runtime::write_value(os, path38, scope1);
+            os.write(":", 1);
+            templet::nodes::runtime::write_value(os, path39, scope1);
+            os.write("|", 1);
+        }
+    }
+}
+
+void render_parser_csv_stream_errors(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path37, name36, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name36, item1, stable1);
+            templet::nodes::runtime::write_value(os, path40, scope1);
+        }
+    }
+}
+
+void render_parser_csv_stream_errors_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path37, name36, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name36, item1, stable1);
+            templet::nodes::runtime::write_value(os, path40, scope1);
+            templet::nodes::runtime::write_value(os, path41, scope1);
+        }
+    }
+}
+
+void render_parser_data_builder(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path8, name7, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name7, item1, stable1);
+            templet::nodes::runtime::write_value(os, path9, scope1);
+            templet::nodes::runtime::write_value(os, path29, scope1);
+            os.write(":", 1);
+            templet::nodes::runtime::write_value(os, path10, scope1);
+            os.write(",", 1);
+        }
+    }
+    {
+        std::vector<templet::types::DataPtr> keep2;
+        bool stable2 = true;
+        const auto cursor2 = templet::nodes::runtime::open_cursor(path6, name5, scope0, keep2, &stable2);
+        while(const auto item2 = cursor2->next()) {
+            const templet::nodes::Scope scope2(scope0, name5, item2, stable2);
+            templet::nodes::runtime::write_value(os, path5, scope2);
+        }
+    }
+    {
+        std::vector<templet::types::DataPtr> keep3;
+        bool stable3 = true;
+        const auto cursor3 = templet::nodes::runtime::open_cursor(path43, name42, scope0, keep3, &stable3);
+        while(const auto item3 = cursor3->next()) {
+            const templet::nodes::Scope scope3(scope0, name42, item3, stable3);
+            templet::nodes::runtime::write_value(os, path42, scope3);
+        }
+    }
+}
+
+void render_parser_data_builder_large_unsigned(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path44, scope0);
+    os.write(" ", 1);
+    templet::nodes::runtime::write_value(os, path45, scope0);
+}
+
+void render_parser_dot_notation_value(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.hostname is: ", 20);
+    templet::nodes::runtime::write_value(os, path46, scope0);
+}
+
+void render_parser_dot_notation_value_array_list(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("server.ips[1] is: ", 18);
+    templet::nodes::runtime::write_value(os, path47, scope0);
+}
+
+void render_parser_dot_notation_value_array_list_without_name(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("server.ips[1] is: ", 18);
+    templet::nodes::runtime::write_value(os, path48, scope0);
+}
+
+void render_parser_dot_notation_value_array_list_without_name_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("server.ips[1] is: ", 18);
+    templet::nodes::runtime::write_value(os, path49, scope0);
+}
+
+void render_parser_dot_notation_value_array_map(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.server is: ", 18);
+    templet::nodes::runtime::write_value(os, path50, scope0);
+}
+
+void render_parser_dot_notation_value_multi(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.server.ip is: ", 21);
+    templet::nodes::runtime::write_value(os, path51, scope0);
+}
+
+void render_parser_dot_notation_value_multi_array(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.servers[1].ips[1] is: ", 29);
+    templet::nodes::runtime::write_value(os, path52, scope0);
+}
+
+void render_parser_dot_notation_value_multi_array_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.servers[1].hostname is: ", 31);
+    templet::nodes::runtime::write_value(os, path53, scope0);
+}
+
+void render_parser_dot_notation_value_multi_array_3(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.server[1].hostname[1] is: ", 33);
+    templet::nodes::runtime::write_value(os, path54, scope0);
+}
+
+void render_parser_dot_notation_value_multi_array_4(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.servers[1].hostname[1] is: ", 34);
+    templet::nodes::runtime::write_value(os, path55, scope0);
+}
+
+void render_parser_dot_notation_value_multi_array_5(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.servers.hostname[1] is: ", 31);
+    templet::nodes::runtime::write_value(os, path56, scope0);
+}
+
+void render_parser_dot_notation_without_dots(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.servers[0]ips[1] is: ", 28);
+    templet::nodes::runtime::write_value(os, path57, scope0);
+}
+
+void render_parser_elif_block(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path0, scope0)) {
+        os.write("Debug mode", 10);
+    }
+    else {
+        if(templet::nodes::runtime::is_set(path1, scope0)) {
+            os.write("Test mode", 9);
+        }
+        else {
+            os.write("Release mode", 12);
+        }
+    }
+}
+
+void render_parser_elif_block_multiple(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path0, scope0)) {
+        os.write("Debug mode", 10);
+    }
+    else {
+        if(templet::nodes::runtime::is_set(path1, scope0)) {
+            os.write("Test mode", 9);
+        }
+        else {
+            if(templet::nodes::runtime::is_set(path2, scope0)) {
+                os.write("Gravity mode", 12);
+            }
+            else {
+                os.write("Release mode", 12);
+            }
+        }
+    }
+}
+
+void render_parser_elif_without_if(std::ostream& /*os*/, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    throw templet::exception::InvalidTagError("ELIF statements cannot be declared without a preceding IF statement");
+}
+
+void render_parser_else_without_if_or_elif(std::ostream& /*os*/, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    throw templet::exception::InvalidTagError("ELSE statements cannot be declared without a preceding IF or ELIF statement");
+}
+
+void render_parser_empty_template(std::ostream& /*os*/, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+}
+
+void render_parser_ends_with_incomplete_tag(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello world { foo", 17);
+}
+
+void render_parser_ends_with_incomplete_tag_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello world {$ foo", 18);
+}
+
+void render_parser_ends_with_incomplete_tag_3(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello world {% foo", 18);
+}
+
+void render_parser_ends_with_tag_opener(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello world {", 13);
+}
+
+void render_parser_ends_with_tag_opener_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello world {$", 14);
+}
+
+void render_parser_ends_with_tag_opener_3(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello world {%", 14);
+}
+
+void render_parser_for_loop_alias_name_collision(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Users: ", 7);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path6, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            templet::nodes::runtime::write_value(os, path5, scope1);
+        }
+    }
+}
+
+void render_parser_for_loop_inner_for_loop(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Users: ", 7);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path6, name58, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name58, item1, stable1);
+            {
+                std::vector<templet::types::DataPtr> keep2;
+                bool stable2 = true;
+                const auto cursor2 = templet::nodes::runtime::open_cursor(path58, name5, scope1, keep2, &stable2);
+                while(const auto item2 = cursor2->next()) {
+                    const templet::nodes::Scope scope2(scope1, name5, item2, stable2);
+                    templet::nodes::runtime::write_value(os, path5, scope2);
+                    os.write(",", 1);
+                }
+            }
+        }
+    }
+}
+
+void render_parser_for_loop_list(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Users: ", 7);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path6, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            templet::nodes::runtime::write_value(os, path5, scope1);
+            os.write(",", 1);
+        }
+    }
+}
+
+void render_parser_for_loop_list_array_index(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Users: ", 7);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path59, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            templet::nodes::runtime::write_value(os, path5, scope1);
+            os.write(",", 1);
+        }
+    }
+}
+
+void render_parser_for_loop_list_array_multi_index(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Users: ", 7);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path60, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            templet::nodes::runtime::write_value(os, path5, scope1);
+            os.write(",", 1);
+        }
+    }
+}
+
+void render_parser_for_loop_list_array_multi_index_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Users: ", 7);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path61, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            templet::nodes::runtime::write_value(os, path62, scope1);
+            os.write(",", 1);
+        }
+    }
+}
+
+void render_parser_for_loop_list_dot_notation(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Users: ", 7);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path63, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            templet::nodes::runtime::write_value(os, path5, scope1);
+            os.write(",", 1);
+        }
+    }
+}
+
+void render_parser_for_loop_list_of_maps_of_lists(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path8, name64, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name64, item1, stable1);
+            {
+                std::vector<templet::types::DataPtr> keep2;
+                bool stable2 = true;
+                const auto cursor2 = templet::nodes::runtime::open_cursor(path65, name5, scope1, keep2, &stable2);
+                while(const auto item2 = cursor2->next()) {
+                    const templet::nodes::Scope scope2(scope1, name5, item2, stable2);
+                    templet::nodes::runtime::write_value(os, path5, scope2);
+                    os.write(",", 1);
+                }
+            }
+        }
+    }
+}
+
+void render_parser_for_loop_map(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path8, name64, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name64, item1, stable1);
+            templet::nodes::runtime::write_value(os, path66, scope1);
+            os.write(",", 1);
+            templet::nodes::runtime::write_value(os, path67, scope1);
+            os.write("<br>", 4);
+        }
+    }
+}
+
+void render_parser_for_loop_stream(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path69, name68, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name68, item1, stable1);
+            templet::nodes::runtime::write_value(os, path68, scope1);
+            os.write(",", 1);
+        }
+    }
+}
+
+void render_parser_for_loop_stream_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path69, name68, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name68, item1, stable1);
+            {
+                std::vector<templet::types::DataPtr> keep2;
+                bool stable2 = true;
+                const auto cursor2 = templet::nodes::runtime::open_cursor(path69, name70, scope1, keep2, &stable2);
+                while(const auto item2 = cursor2->next()) {
+                    const templet::nodes::Scope scope2(scope1, name70, item2, stable2);
+                    templet::nodes::runtime::write_value(os, path70, scope2);
+                }
+            }
+            os.write(",", 1);
+        }
+    }
+}
+
+void render_parser_for_loop_table_inner_loop(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path8, name71, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name71, item1, stable1);
+            {
+                std::vector<templet::types::DataPtr> keep2;
+                bool stable2 = true;
+                const auto cursor2 = templet::nodes::runtime::open_cursor(path8, name72, scope1, keep2, &stable2);
+                while(const auto item2 = cursor2->next()) {
+                    const templet::nodes::Scope scope2(scope1, name72, item2, stable2);
+                    templet::nodes::runtime::write_value(os, path73, scope2);
+                    templet::nodes::runtime::write_value(os, path74, scope2);
+                    os.write(",", 1);
+                }
+            }
+        }
+    }
+}
+
+void render_parser_if_block_nested_dupe_name(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path75, scope0)) {
+        if(templet::nodes::runtime::is_set(path75, scope0)) {
+            os.write("Hello", 5);
+        }
+    }
+}
+
+void render_parser_if_block_text_after_endif(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Hello", 5);
+    if(templet::nodes::runtime::is_set(path75, scope0)) {
+        os.write(" world", 6);
+    }
+    os.write(". End of file.", 14);
+}
+
+void render_parser_if_dot_notation(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path76, scope0)) {
+        templet::nodes::runtime::write_value(os, path76, scope0);
+    }
+}
+
+void render_parser_if_dot_notation_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path51, scope0)) {
+        templet::nodes::runtime::write_value(os, path51, scope0);
+    }
+}
+
+void render_parser_if_dot_notation_with_arrays(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path77, scope0)) {
+        templet::nodes::runtime::write_value(os, path77, scope0);
+    }
+}
+
+void render_parser_if_dot_notation_with_arrays_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path53, scope0)) {
+        templet::nodes::runtime::write_value(os, path53, scope0);
+    }
+}
+
+void render_parser_if_dot_notation_with_arrays_end_index(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path78, scope0)) {
+        templet::nodes::runtime::write_value(os, path78, scope0);
+    }
+}
+
+void render_parser_if_dot_notation_with_arrays_end_index_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path79, scope0)) {
+        templet::nodes::runtime::write_value(os, path79, scope0);
+    }
+}
+
+void render_parser_if_else_block(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path0, scope0)) {
+        os.write("Debug mode", 10);
+    }
+    else {
+        os.write("Release mode", 12);
+    }
+}
+
+void render_parser_if_else_block_multiple_elses(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path0, scope0)) {
+        os.write("Debug mode", 10);
+    }
+    else {
+        os.write("Release mode", 12);
+        throw templet::exception::InvalidTagError("ELSE statements cannot be declared without a preceding IF or ELIF statement");
+    }
+}
+
+void render_parser_if_else_block_text_after_endif(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path0, scope0)) {
+        os.write("Debug", 5);
+    }
+    else {
+        if(templet::nodes::runtime::is_set(path1, scope0)) {
+            os.write("Test", 4);
+        }
+        else {
+            os.write("Release", 7);
+        }
+    }
+    os.write(" mode", 5);
+}
+
+void render_parser_if_else_block_text_after_endif_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path81, name80, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name80, item1, stable1);
+            if(templet::nodes::runtime::is_set(path0, scope1)) {
+                templet::nodes::runtime::write_value(os, path80, scope1);
+            }
+            else {
+                os.write("B", 1);
+            }
+            os.write("-", 1);
+        }
+    }
+    os.write("end", 3);
+}
+
+void render_parser_if_inside_elif(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path0, scope0)) {
+        os.write("Debug mode", 10);
+    }
+    else {
+        if(templet::nodes::runtime::is_set(path1, scope0)) {
+            os.write("Test mode", 9);
+            if(templet::nodes::runtime::is_set(path2, scope0)) {
+                os.write("Gravity", 7);
+            }
+        }
+    }
+}
+
+void render_parser_if_inside_else(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path0, scope0)) {
+        os.write("Debug mode", 10);
+    }
+    else {
+        if(templet::nodes::runtime::is_set(path1, scope0)) {
+            os.write("Test mode", 9);
+        }
+        else {
+            os.write("Release mode", 12);
+            if(templet::nodes::runtime::is_set(path2, scope0)) {
+                os.write("Gravity", 7);
+            }
+        }
+    }
+}
+
+void render_parser_if_inside_if(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path0, scope0)) {
+        os.write("Debug mode", 10);
+        if(templet::nodes::runtime::is_set(path1, scope0)) {
+            os.write("Test mode", 9);
+        }
+    }
+}
+
+void render_parser_if_value_tag_name_with_outer_space(std::ostream& /*os*/, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path82, scope0)) {
+    }
+}
+
+void render_parser_ignored_tag(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello {world}", 13);
+}
+
+void render_parser_ignored_tag_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello {\\world}", 14);
+}
+
+void render_parser_ignored_tag_3(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello {\\\\world}", 15);
+}
+
+void render_parser_ignored_tag_4(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello {*world}", 14);
+}
+
+void render_parser_ignored_tag_5(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello {$world}", 14);
+}
+
+void render_parser_invalid_dot_notation_value(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.hostname is: ", 20);
+    templet::nodes::runtime::write_value(os, path83, scope0);
+}
+
+void render_parser_invalid_dot_notation_value_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("config.hostname is: ", 20);
+    templet::nodes::runtime::write_value(os, path84, scope0);
+}
+
+void render_parser_json_array_access(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path85, scope0);
+}
+
+void render_parser_json_array_access_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path86, scope0);
+    templet::nodes::runtime::write_value(os, path87, scope0);
+    templet::nodes::runtime::write_value(os, path88, scope0);
+}
+
+void render_parser_json_null_and_false_are_not_set(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path89, scope0)) {
+        os.write("n", 1);
+    }
+    if(templet::nodes::runtime::is_set(path90, scope0)) {
+        os.write("f", 1);
+    }
+    if(templet::nodes::runtime::is_set(path91, scope0)) {
+        os.write("t", 1);
+    }
+    if(templet::nodes::runtime::is_set(path92, scope0)) {
+        os.write("z", 1);
+    }
+    os.write("|", 1);
+    if(templet::nodes::runtime::is_set(path93, scope0)) {
+        os.write("n", 1);
+    }
+    if(templet::nodes::runtime::is_set(path94, scope0)) {
+        os.write("f", 1);
+    }
+    if(templet::nodes::runtime::is_set(path95, scope0)) {
+        os.write("t", 1);
+    }
+    if(templet::nodes::runtime::is_set(path96, scope0)) {
+        os.write("z", 1);
+    }
+    os.write("|", 1);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path98, name97, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name97, item1, stable1);
+            os.write("[", 1);
+            templet::nodes::runtime::write_value(os, path97, scope1);
+            os.write("]", 1);
+        }
+    }
+}
+
+void render_parser_json_render(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path99, scope0);
+    os.write(":", 1);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path8, name7, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name7, item1, stable1);
+            templet::nodes::runtime::write_value(os, path9, scope1);
+            templet::nodes::runtime::write_value(os, path29, scope1);
+            os.write("=", 1);
+            templet::nodes::runtime::write_value(os, path10, scope1);
+            os.write(",", 1);
+        }
+    }
+    templet::nodes::runtime::write_value(os, path100, scope0);
+    os.write("/", 1);
+    templet::nodes::runtime::write_value(os, path101, scope0);
+    if(templet::nodes::runtime::is_set(path102, scope0)) {
+        os.write("+", 1);
+    }
+    if(templet::nodes::runtime::is_set(path103, scope0)) {
+        os.write("-", 1);
+    }
+    if(templet::nodes::runtime::is_set(path104, scope0)) {
+        os.write("-", 1);
+    }
+    {
+        std::vector<templet::types::DataPtr> keep2;
+        bool stable2 = true;
+        const auto cursor2 = templet::nodes::runtime::open_cursor(path105, name11, scope0, keep2, &stable2);
+        while(const auto item2 = cursor2->next()) {
+            const templet::nodes::Scope scope2(scope0, name11, item2, stable2);
+            templet::nodes::runtime::write_value(os, path11, scope2);
+        }
+    }
+}
+
+void render_parser_lazy_list_and_map(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path6, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            templet::nodes::runtime::write_value(os, path5, scope1);
+            os.write(",", 1);
+        }
+    }
+    templet::nodes::runtime::write_value(os, path46, scope0);
+}
+
+void render_parser_lazy_value_computed_per_render(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path106, scope0);
+    if(templet::nodes::runtime::is_set(path106, scope0)) {
+        os.write(",", 1);
+        templet::nodes::runtime::write_value(os, path106, scope0);
+    }
+}
+
+void render_parser_lazy_value_not_computed_in_false_branch(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path107, scope0)) {
+        templet::nodes::runtime::write_value(os, path108, scope0);
+    }
+}
+
+void render_parser_lazy_value_not_computed_in_false_branch_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path107, scope0)) {
+        templet::nodes::runtime::write_value(os, path108, scope0);
+        os.write(" ", 1);
+        templet::nodes::runtime::write_value(os, path108, scope0);
+    }
+}
+
+void render_parser_lists_of_lists(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path109, scope0);
+    os.write(" ", 1);
+    templet::nodes::runtime::write_value(os, path110, scope0);
+}
+
+void render_parser_loop_invariant_blocks(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path6, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            os.write("<", 1);
+            templet::nodes::runtime::write_value(os, path111, scope1);
+            os.write(">", 1);
+            {
+                std::vector<templet::types::DataPtr> keep2;
+                bool stable2 = true;
+                const auto cursor2 = templet::nodes::runtime::open_cursor(path69, name68, scope1, keep2, &stable2);
+                while(const auto item2 = cursor2->next()) {
+                    const templet::nodes::Scope scope2(scope1, name68, item2, stable2);
+                    templet::nodes::runtime::write_value(os, path68, scope2);
+                }
+            }
+            if(templet::nodes::runtime::is_set(path5, scope1)) {
+                templet::nodes::runtime::write_value(os, path5, scope1);
+            }
+            os.write(";", 1);
+        }
+    }
+}
+
+void render_parser_loop_invariant_blocks_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path6, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            {
+                std::vector<templet::types::DataPtr> keep2;
+                bool stable2 = true;
+                const auto cursor2 = templet::nodes::runtime::open_cursor(path69, name68, scope1, keep2, &stable2);
+                while(const auto item2 = cursor2->next()) {
+                    const templet::nodes::Scope scope2(scope1, name68, item2, stable2);
+                    templet::nodes::runtime::write_value(os, path5, scope2);
+                    templet::nodes::runtime::write_value(os, path68, scope2);
+                }
+            }
+            os.write(";", 1);
+        }
+    }
+}
+
+void render_parser_ndjson_stream(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path37, name36, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name36, item1, stable1);
+            templet::nodes::runtime::write_value(os, path38, scope1);
+            if(templet::nodes::runtime::is_set(path112, scope1)) {
+                os.write("*", 1);
+            }
+            os.write(":", 1);
+            {
+                std::vector<templet::types::DataPtr> keep2;
+                bool stable2 = true;
+                const auto cursor2 = templet::nodes::runtime::open_cursor(path113, name11, scope1, keep2, &stable2);
+                while(const auto item2 = cursor2->next()) {
+                    const templet::nodes::Scope scope2(scope1, name11, item2, stable2);
+                    templet::nodes::runtime::write_value(os, path11, scope2);
+                }
+            }
+            os.write("|", 1);
+        }
+    }
+}
+
+void render_parser_number_values(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path106, scope0);
+    os.write(" items at ", 10);
+    templet::nodes::runtime::write_value(os, path114, scope0);
+    os.write(": ", 2);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path116, name115, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name115, item1, stable1);
+            templet::nodes::runtime::write_value(os, path115, scope1);
+            os.write(",", 1);
+        }
+    }
+}
+
+void render_parser_plain_text(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello world", 11);
+}
+
+void render_parser_repeated_paths_are_resolved_once(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path117, scope0);
+    os.write("|", 1);
+    if(templet::nodes::runtime::is_set(path117, scope0)) {
+        templet::nodes::runtime::write_value(os, path117, scope0);
+    }
+    os.write("|", 1);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path118, name97, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name97, item1, stable1);
+            templet::nodes::runtime::write_value(os, path119, scope1);
+            templet::nodes::runtime::write_value(os, path117, scope1);
+            templet::nodes::runtime::write_value(os, path119, scope1);
+            os.write(";", 1);
+        }
+    }
+    templet::nodes::runtime::write_value(os, path120, scope0);
+    templet::nodes::runtime::write_value(os, path120, scope0);
+}
+
+void render_parser_repeated_paths_are_resolved_once_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path119, scope0);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path118, name97, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name97, item1, stable1);
+            templet::nodes::runtime::write_value(os, path119, scope1);
+        }
+    }
+    templet::nodes::runtime::write_value(os, path119, scope0);
+}
+
+void render_parser_result(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("foo bar baz", 11);
+}
+
+void render_parser_snapshot_file(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello ", 6);
+    templet::nodes::runtime::write_value(os, path42, scope0);
+}
+
+void render_parser_snapshot_render(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path99, scope0);
+    os.write(":", 1);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path8, name7, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name7, item1, stable1);
+            templet::nodes::runtime::write_value(os, path9, scope1);
+            templet::nodes::runtime::write_value(os, path29, scope1);
+            os.write("=", 1);
+            templet::nodes::runtime::write_value(os, path10, scope1);
+            os.write(",", 1);
+        }
+    }
+    {
+        std::vector<templet::types::DataPtr> keep2;
+        bool stable2 = true;
+        const auto cursor2 = templet::nodes::runtime::open_cursor(path6, name5, scope0, keep2, &stable2);
+        while(const auto item2 = cursor2->next()) {
+            const templet::nodes::Scope scope2(scope0, name5, item2, stable2);
+            templet::nodes::runtime::write_value(os, path5, scope2);
+        }
+    }
+    if(templet::nodes::runtime::is_set(path121, scope0)) {
+        os.write("!", 1);
+    }
+}
+
+void render_parser_stream_array_access(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path122, scope0);
+}
+
+void render_parser_table_array_access(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path123, scope0);
+    os.write(" ", 1);
+    templet::nodes::runtime::write_value(os, path124, scope0);
+    os.write(" ", 1);
+    templet::nodes::runtime::write_value(os, path125, scope0);
+}
+
+void render_parser_unrecognized_tag(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello {world}", 13);
+}
+
+void render_parser_unrecognized_tag_2(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello {*world}", 14);
+}
+
+void render_parser_unset_if_block(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("This is ", 8);
+    if(templet::nodes::runtime::is_set(path126, scope0)) {
+        os.write("not ", 4);
+    }
+    os.write("a test", 6);
+}
+
+void render_parser_unset_unclosed_if_block(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Hello ", 6);
+    if(templet::nodes::runtime::is_set(path75, scope0)) {
+        os.write("world", 5);
+    }
+}
+
+void render_parser_unset_variables(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello, ", 7);
+    templet::nodes::runtime::write_value(os, path3, scope0);
+    os.write(" ", 1);
+    templet::nodes::runtime::write_value(os, path4, scope0);
+}
+
+void render_parser_update_nested_blocks(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path107, scope0)) {
+        {
+            std::vector<templet::types::DataPtr> keep1;
+            bool stable1 = true;
+            const auto cursor1 = templet::nodes::runtime::open_cursor(path6, name5, scope0, keep1, &stable1);
+            while(const auto item1 = cursor1->next()) {
+                const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+                templet::nodes::runtime::write_value(os, path5, scope1);
+                os.write(",", 1);
+            }
+        }
+    }
+    os.write("!", 1);
+}
+
+void render_parser_update_without_previous_result(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("hello ", 6);
+    templet::nodes::runtime::write_value(os, path42, scope0);
+}
+
+void render_parser_valid_if_value_tag_name(std::ostream& /*os*/, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path82, scope0)) {
+    }
+}
+
+void render_parser_valid_value_tag_name(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path127, scope0);
+}
+
+void render_parser_validate_structure(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path128, scope0)) {
+        os.write("A", 1);
+    }
+    os.write("B", 1);
+}
+
+void render_parser_validated_template_render(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path6, name5, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name5, item1, stable1);
+            if(templet::nodes::runtime::is_set(path129, scope1)) {
+                os.write("*", 1);
+            }
+            templet::nodes::runtime::write_value(os, path5, scope1);
+            os.write(",", 1);
+        }
+    }
+}
+
+void render_parser_value_tag_name_with_outer_space(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    templet::nodes::runtime::write_value(os, path127, scope0);
+}
+
+void render_paths(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    if(templet::nodes::runtime::is_set(path76, scope0)) {
+        templet::nodes::runtime::write_value(os, path76, scope0);
+    }
+    os.write("/", 1);
+    if(templet::nodes::runtime::is_set(path51, scope0)) {
+        templet::nodes::runtime::write_value(os, path51, scope0);
+    }
+    os.write("\n", 1);
+}
+
+void render_rows(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    {
+        std::vector<templet::types::DataPtr> keep1;
+        bool stable1 = true;
+        const auto cursor1 = templet::nodes::runtime::open_cursor(path37, name36, scope0, keep1, &stable1);
+        while(const auto item1 = cursor1->next()) {
+            const templet::nodes::Scope scope1(scope0, name36, item1, stable1);
+            templet::nodes::runtime::write_value(os, path38, scope1);
+            templet::nodes::runtime::write_value(os, path130, scope1);
+        }
+    }
+}
+
+void render_unclosed(std::ostream& os, const templet::DataMap& values) {
+    const templet::nodes::Scope scope0(values);
+    os.write("Hello ", 6);
+    if(templet::nodes::runtime::is_set(path75, scope0)) {
+        os.write("world", 5);
+    }
+}
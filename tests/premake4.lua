@@ -1,24 +1,50 @@
 solution "Templet"
     configurations {"Release", "Debug"}
     
+    configuration "Release"
+        targetdir "build/release"
+        buildoptions {"-O3", "-Wall", "-Wextra", "-Wpedantic"}
+        
+    configuration "Debug"
+        targetdir "build/debug"
+        flags {"Symbols"}
+        
     project "test_all"
         kind "ConsoleApp"
         language "C++"
         location "build"
         files {
             "test_all.cpp",
+            "compiled_templates.cpp",
             "../*.cpp"
         }
         includedirs {"../", "../gtest/include"}
         libdirs {"../gtest/build"}
-        links {"libgtest"}
-        
-    configuration "Release"
-        targetdir "build/release"
-        buildoptions {"-O3", "-Wall", "-Wextra", "-Wpedantic"}
-        
-    configuration "Debug"
-        targetdir "build/debug"
-        flags {"Symbols"}
+        links {"libgtest", "pthread"}
+
+    project "bench_all"
+        kind "ConsoleApp"
+        language "C++"
+        location "build"
+        files {
+            "bench_all.cpp",
+            "compiled_templates.cpp",
+            "../*.cpp"
+        }
+        includedirs {"../"}
+        links {"pthread"}
+
+    -- Regenerate compiled_templates.cpp after changing templates/ or the generator:
+    -- templetc compiled_templates.cpp render_NAME=templates/NAME.tpl ...
+    -- with every file in templates/ in name order (see COMPILED_TEMPLATES in test_all.cpp)
+    project "templetc"
+        kind "ConsoleApp"
+        language "C++"
+        location "build"
+        files {
+            "../tools/templetc.cpp",
+            "../*.cpp"
+        }
+        includedirs {"../"}
+        links {"pthread"}
         
-        
\ No newline at end of file
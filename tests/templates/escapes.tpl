@@ -0,0 +1 @@
+hello {world} {\world} {\$world} {*world} "quoted"?? 	{$ first_name }
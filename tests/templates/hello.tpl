@@ -0,0 +1 @@
+hello, {$first_name} {$last_name}
@@ -0,0 +1,2 @@
+{% for users as user %}{$ user },{% endfor %}
+{% for servers as s %}{$ s.name } {$ s.load }:{% for s.tags as tag %}{$ tag }{% endfor %};{% endfor %}
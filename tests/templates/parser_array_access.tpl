@@ -0,0 +1 @@
+Items in a list: {$ items[0] }, {$ items[1] }, {$ items[2] }
\ No newline at end of file
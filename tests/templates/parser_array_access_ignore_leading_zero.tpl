@@ -0,0 +1 @@
+Items in a list: {$ items[00] }, {$ items[01] }, {$ items[02] }
\ No newline at end of file
@@ -0,0 +1 @@
+Items in a list: {$ items[x] }
\ No newline at end of file
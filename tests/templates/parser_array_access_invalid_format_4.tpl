@@ -0,0 +1 @@
+Items in a list: {$ items[] }
\ No newline at end of file
@@ -0,0 +1 @@
+Value: {$ items[1.56] }
\ No newline at end of file
@@ -0,0 +1 @@
+Value: {$ items[0x01] }
\ No newline at end of file
@@ -0,0 +1 @@
+Items in a list: {$ items[3] }
\ No newline at end of file
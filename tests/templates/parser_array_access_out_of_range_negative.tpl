@@ -0,0 +1 @@
+Items in a list: {$ items[-1] }
\ No newline at end of file
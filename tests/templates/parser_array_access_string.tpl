@@ -0,0 +1 @@
+{$ items[0][0] }
\ No newline at end of file
@@ -0,0 +1 @@
+{$ item[0] }
\ No newline at end of file
@@ -0,0 +1 @@
+{% for servers as s %}{$ s.name }#{$ s.id }{% if s.online %}*{% endif %} {$ s.location.city }@{$ s.location.latitude }:{% for s.tags as tag %}{$ tag },{% endfor %}{% for s.ports as port %}{$ port },{% endfor %}|{% endfor %}{$ first.traffic }
\ No newline at end of file
@@ -0,0 +1 @@
+{% for rows as row %}{$ row.name }:{$ row.city }|{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% for rows as row %}{$ row.a }{% endfor %}
\ No newline at end of file
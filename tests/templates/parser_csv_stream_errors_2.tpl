@@ -0,0 +1 @@
+{% for rows as row %}{$ row.a }{$ row.b }{% endfor %}
\ No newline at end of file
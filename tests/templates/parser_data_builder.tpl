@@ -0,0 +1 @@
+{% for servers as s %}{$ s.name }{$ s.id }:{$ s.load },{% endfor %}{% for users as user %}{$ user }{% endfor %}{% for names as name %}{$ name }{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+{$ max } {$ fits }
\ No newline at end of file
@@ -0,0 +1 @@
+server.ips[1] is: {$ server.[1] }
\ No newline at end of file
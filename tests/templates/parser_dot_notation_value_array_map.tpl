@@ -0,0 +1 @@
+config.server is: {$ config.server }
\ No newline at end of file
@@ -0,0 +1 @@
+config.server.ip is: {$ config.server.ip }
\ No newline at end of file
@@ -0,0 +1 @@
+config.servers[1].hostname is: {$ config.servers[1].hostname }
\ No newline at end of file
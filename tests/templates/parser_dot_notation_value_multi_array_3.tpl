@@ -0,0 +1 @@
+config.server[1].hostname[1] is: {$ config.server[1].hostname[1] }
\ No newline at end of file
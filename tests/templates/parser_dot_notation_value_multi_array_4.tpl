@@ -0,0 +1 @@
+config.servers[1].hostname[1] is: {$ config.servers[1].hostname[1] }
\ No newline at end of file
@@ -0,0 +1 @@
+config.servers.hostname[1] is: {$ config.servers.hostname[1] }
\ No newline at end of file
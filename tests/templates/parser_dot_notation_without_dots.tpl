@@ -0,0 +1 @@
+config.servers[0]ips[1] is: {$ config.servers[0]ips[1] }
\ No newline at end of file
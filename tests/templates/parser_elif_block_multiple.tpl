@@ -0,0 +1 @@
+{% if debug %}Debug mode{% elif test %}Test mode{% elif gravity %}Gravity mode{% else %}Release mode{% endif %}
\ No newline at end of file
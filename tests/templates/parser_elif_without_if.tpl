@@ -0,0 +1 @@
+{% elif debug %}Debug mode{% endif %}
\ No newline at end of file
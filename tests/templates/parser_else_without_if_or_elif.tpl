@@ -0,0 +1 @@
+{% else %}Debug mode{% endif %}
\ No newline at end of file
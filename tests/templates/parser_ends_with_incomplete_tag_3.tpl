@@ -0,0 +1 @@
+hello world {% foo
\ No newline at end of file
@@ -0,0 +1 @@
+hello world {
\ No newline at end of file
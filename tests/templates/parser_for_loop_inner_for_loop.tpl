@@ -0,0 +1 @@
+Users: {% for users as _users %}{% for _users as user %}{$ user },{% endfor %}{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+Users: {% for users[0] as user %}{$ user },{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+Users: {% for groups[0][1] as user %}{$ user },{% endfor %}
\ No newline at end of file
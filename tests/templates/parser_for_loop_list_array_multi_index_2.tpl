@@ -0,0 +1 @@
+Users: {% for groups[0] as user %}{$ user[0] },{% endfor %}
\ No newline at end of file
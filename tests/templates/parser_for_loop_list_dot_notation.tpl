@@ -0,0 +1 @@
+Users: {% for users.active as user %}{$ user },{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% for servers as server %}{% for server.users as user %}{$ user },{% endfor %}{% endfor %}
\ No newline at end of file
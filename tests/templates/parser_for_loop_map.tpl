@@ -0,0 +1 @@
+{% for servers as server %}{$ server.ip },{$ server.name }<br>{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% for numbers as n %}{$ n },{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% for numbers as n %}{% for numbers as m %}{$ m }{% endfor %},{% endfor %}
\ No newline at end of file
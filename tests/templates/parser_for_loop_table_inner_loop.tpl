@@ -0,0 +1 @@
+{% for servers as x %}{% for servers as y %}{$ x.name }{$ y.name },{% endfor %}{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% if is_world %}{% if is_world %}Hello{% endif %}{% endif %}
\ No newline at end of file
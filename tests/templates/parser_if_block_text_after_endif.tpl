@@ -0,0 +1 @@
+Hello{% if is_world %} world{% endif %}. End of file.
\ No newline at end of file
@@ -0,0 +1 @@
+{% if config.server.hostname %}{$ config.server.hostname }{% endif %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% if config.server.ip %}{$ config.server.ip }{% endif %}
\ No newline at end of file
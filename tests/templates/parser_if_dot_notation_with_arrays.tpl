@@ -0,0 +1 @@
+{% if config.servers[0].hostname %}{$ config.servers[0].hostname }{% endif %}
\ No newline at end of file
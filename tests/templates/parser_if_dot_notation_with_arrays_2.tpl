@@ -0,0 +1 @@
+{% if config.servers[1].hostname %}{$ config.servers[1].hostname }{% endif %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% if config.servers[0].hostnames[0] %}{$ config.servers[0].hostnames[0] }{% endif %}
\ No newline at end of file
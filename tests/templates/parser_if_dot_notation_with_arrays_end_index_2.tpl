@@ -0,0 +1 @@
+{% if config.servers[0].hostnames[2] %}{$ config.servers[0].hostnames[2] }{% endif %}
\ No newline at end of file
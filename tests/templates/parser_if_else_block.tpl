@@ -0,0 +1 @@
+{% if debug %}Debug mode{% else %}Release mode{% endif %}
\ No newline at end of file
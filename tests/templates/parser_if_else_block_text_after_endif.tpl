@@ -0,0 +1 @@
+{% if debug %}Debug{% elif test %}Test{% else %}Release{% endif %} mode
\ No newline at end of file
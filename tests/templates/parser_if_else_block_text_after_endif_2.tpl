@@ -0,0 +1 @@
+{% for modes as mode %}{% if debug %}{$ mode }{% else %}B{% endif %}-{% endfor %}end
\ No newline at end of file
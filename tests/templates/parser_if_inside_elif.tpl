@@ -0,0 +1 @@
+{% if debug %}Debug mode{% elif test %}Test mode{% if gravity %}Gravity{% endif %}{% endif %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% if debug %}Debug mode{% if test %}Test mode{% endif %}
\ No newline at end of file
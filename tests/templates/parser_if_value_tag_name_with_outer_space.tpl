@@ -0,0 +1 @@
+{%    if    azAZ09_-    %}
\ No newline at end of file
@@ -0,0 +1 @@
+config.hostname is: {$ config...hostname }
\ No newline at end of file
@@ -0,0 +1 @@
+{$ a.b[3].c }
\ No newline at end of file
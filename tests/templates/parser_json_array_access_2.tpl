@@ -0,0 +1 @@
+{$ a.b[0] }{$ a.b[2] }{$ a.b[4] }
\ No newline at end of file
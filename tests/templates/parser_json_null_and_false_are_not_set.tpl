@@ -0,0 +1 @@
+{% if obj.n %}n{% endif %}{% if obj.f %}f{% endif %}{% if obj.t %}t{% endif %}{% if obj.z %}z{% endif %}|{% if arr[0] %}n{% endif %}{% if arr[1] %}f{% endif %}{% if arr[2] %}t{% endif %}{% if arr[3] %}z{% endif %}|{% for arr as item %}[{$ item }]{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+{$ title }:{% for servers as s %}{$ s.name }{$ s.id }={$ s.load },{% endfor %}{$ owner.name }/{$ owner.city }{% if enabled %}+{% endif %}{% if disabled %}-{% endif %}{% if missing %}-{% endif %}{% for tags as tag %}{$ tag }{% endfor %}
\ No newline at end of file
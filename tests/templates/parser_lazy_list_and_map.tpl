@@ -0,0 +1 @@
+{% for users as user %}{$ user },{% endfor %}{$ config.hostname }
\ No newline at end of file
@@ -0,0 +1 @@
+{$ count }{% if count %},{$ count }{% endif %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% if show %}{$ report }{% endif %}
\ No newline at end of file
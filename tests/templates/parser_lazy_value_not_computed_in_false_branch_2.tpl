@@ -0,0 +1 @@
+{% if show %}{$ report } {$ report }{% endif %}
\ No newline at end of file
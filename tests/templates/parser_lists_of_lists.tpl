@@ -0,0 +1 @@
+{$ items[0][1] } {$ items[1][1] }
\ No newline at end of file
@@ -0,0 +1 @@
+{% for users as user %}<{$ site.name }>{% for numbers as n %}{$ n }{% endfor %}{% if user %}{$ user }{% endif %};{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% for users as user %}{% for numbers as n %}{$ user }{$ n }{% endfor %};{% endfor %}
\ No newline at end of file
@@ -0,0 +1 @@
+{% for rows as row %}{$ row.name }{% if row.admin %}*{% endif %}:{% for row.tags as tag %}{$ tag }{% endfor %}|{% endfor %}
\ No newline at end of file
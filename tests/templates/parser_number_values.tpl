@@ -0,0 +1 @@
+{$ count } items at {$ price }: {% for sizes as size %}{$ size },{% endfor %}
\ No newline at end of file
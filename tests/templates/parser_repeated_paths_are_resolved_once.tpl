@@ -0,0 +1 @@
+{$ user.name }|{% if user.name %}{$ user.name }{% endif %}|{% for items as item %}{$ item.id }{$ user.name }{$ item.id };{% endfor %}{$ user.missing }{$ user.missing }
\ No newline at end of file
@@ -0,0 +1 @@
+{$ item.id }{% for items as item %}{$ item.id }{% endfor %}{$ item.id }
\ No newline at end of file
@@ -0,0 +1 @@
+foo bar baz
\ No newline at end of file
@@ -0,0 +1 @@
+hello {$ name }
\ No newline at end of file
@@ -0,0 +1 @@
+{$ title }:{% for servers as s %}{$ s.name }{$ s.id }={$ s.load },{% endfor %}{% for users as user %}{$ user }{% endfor %}{% if empty %}!{% endif %}
\ No newline at end of file
@@ -0,0 +1 @@
+{$ numbers[0] }
\ No newline at end of file
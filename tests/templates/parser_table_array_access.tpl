@@ -0,0 +1 @@
+{$ servers[1].name } {$ servers[2].name } {$ servers[0].port }
\ No newline at end of file
@@ -0,0 +1 @@
+This is {% if is_not_test %}not {% endif %}a test
\ No newline at end of file
@@ -0,0 +1 @@
+{% if show %}{% for users as user %}{$ user },{% endfor %}{% endif %}!
\ No newline at end of file
@@ -0,0 +1 @@
+{% if a %}A{% endfor %}B
\ No newline at end of file
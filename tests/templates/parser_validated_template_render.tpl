@@ -0,0 +1 @@
+{% for users as user %}{% if admin %}*{% endif %}{$ user },{% endfor %}
\ No newline at end of file
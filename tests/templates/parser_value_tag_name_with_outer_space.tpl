@@ -0,0 +1 @@
+{$   azAZ09-_   }
\ No newline at end of file
@@ -0,0 +1 @@
+{% if config.server.hostname %}{$ config.server.hostname }{% endif %}/{% if config.server.ip %}{$ config.server.ip }{% endif %}
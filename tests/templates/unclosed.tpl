@@ -0,0 +1 @@
+Hello {% if is_world %}world
\ No newline at end of file
@@ -3,12 +3,26 @@ CONFIG += console
 CONFIG -= app_bundle
 CONFIG -= qt
 
-SOURCES += test_all.cpp ..\templet.cpp \
+SOURCES += test_all.cpp compiled_templates.cpp ..\templet.cpp \
     ..\types.cpp \
-    ..\nodes.cpp
+    ..\nodes.cpp \
+    ..\async.cpp \
+    ..\batch.cpp \
+    ..\builder.cpp \
+    ..\chunks.cpp \
+    ..\codegen.cpp \
+    ..\compiled.cpp \
+    ..\csv.cpp \
+    ..\file.cpp \
+    ..\json.cpp \
+    ..\literal.cpp \
+    ..\mapping.cpp \
+    ..\segments.cpp \
+    ..\snapshot.cpp
 
 INCLUDEPATH += ..\gtest\include ..\
 
 LIBS += -L..\templet\gtest\build -llibgtest
+unix:LIBS += -lpthread
 
 QMAKE_CXXFLAGS += -std=c++11
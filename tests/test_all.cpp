@@ -1,9 +1,27 @@
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include "gtest/gtest.h"
+#include "async.hpp"
+#include "batch.hpp"
+#include "bind.hpp"
+#include "builder.hpp"
+#include "codegen.hpp"
+#include "compiled.hpp"
+#include "file.hpp"
+#include "csv.hpp"
+#include "json.hpp"
+#include "literal.hpp"
 #include "ptrutil.hpp"
+#include "segments.hpp"
+#include "snapshot.hpp"
 #include "templet.hpp"
 
 class TempletParserTest : public ::testing::Test {
@@ -113,6 +131,75 @@ TEST(MakeDataHelperTest, StringVectorToDataPtr) {
     EXPECT_EQ(r[2]->getValue(), "third");
 }
 
+TEST(MakeDataHelperTest, LazyToDataPtr) {
+    int calls = 0;
+    DataPtr res = make_lazy(types::DataType::String, [&calls]{
+        ++calls;
+        return make_data("john");
+    });
+
+    EXPECT_EQ(res->type(), types::DataType::String);
+    EXPECT_EQ(calls, 0);
+    EXPECT_EQ(res->getValue(), "john");
+    EXPECT_EQ(res->getValue(), "john");
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(MakeDataHelperTest, LazyWrongType) {
+    DataPtr res = make_lazy(types::DataType::List, []{
+        return make_data("john");
+    });
+
+    ASSERT_THROW(res->getList(), std::runtime_error);
+}
+
+TEST(MakeDataHelperTest, IntegerToDataPtr) {
+    DataPtr res = make_data(-42);
+    EXPECT_EQ(res->type(), types::DataType::Integer);
+    EXPECT_EQ(res->getValue(), "-42");
+    EXPECT_EQ(res->empty(), false);
+
+    res = make_data(std::numeric_limits<long long>::min());
+    EXPECT_EQ(res->getValue(), "-9223372036854775808");
+
+    // Too large for long long
+    res = make_data(std::numeric_limits<unsigned long long>::max());
+    EXPECT_EQ(res->type(), types::DataType::String);
+    EXPECT_EQ(res->getValue(), "18446744073709551615");
+}
+
+TEST(MakeDataHelperTest, FloatToDataPtr) {
+    DataPtr res = make_data(0.1);
+    EXPECT_EQ(res->type(), types::DataType::Float);
+    EXPECT_EQ(res->getValue(), "0.1");
+
+    res = make_data(0.1 + 0.2);
+    EXPECT_EQ(res->getValue(), "0.30000000000000004");
+
+    res = make_data(2.5f);
+    EXPECT_EQ(res->getValue(), "2.5");
+}
+
+TEST(MakeDataHelperTest, NumbersSharedBetweenThreads) {
+    const auto integer = make_data(12345);
+    const auto number = make_data(0.25);
+    std::vector<std::string> results(4);
+    std::vector<std::thread> threads;
+    for(auto& result : results) {
+        threads.emplace_back([&integer, &number, &result]{
+            for(int i = 0; i < 100; ++i) {
+                result = integer->getValue() + "," + number->getValue();
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(const auto& result : results) {
+        EXPECT_EQ(result, "12345,0.25");
+    }
+}
+
 //
 // Test the parser
 //
@@ -345,6 +432,24 @@ TEST_F(TempletParserTest, IfElseBlockMultipleElses) {
     ASSERT_THROW(tpl.parse(map), templet::exception::InvalidTagError);
 }
 
+TEST_F(TempletParserTest, IfElseBlockTextAfterEndif) {
+    tpl.setTemplate("{% if debug %}Debug{% elif test %}Test{% else %}Release{% endif %} mode");
+    EXPECT_EQ(tpl.parse(map), "Release mode");
+
+    map["test"] = make_data("true");
+    EXPECT_EQ(tpl.parse(map), "Test mode");
+
+    map["debug"] = make_data("true");
+    EXPECT_EQ(tpl.parse(map), "Debug mode");
+
+    map["modes"] = make_data({"1", "2"});
+    tpl.setTemplate("{% for modes as mode %}{% if debug %}{$ mode }{% else %}B{% endif %}-{% endfor %}end");
+    EXPECT_EQ(tpl.parse(map), "1-2-end");
+
+    map.erase("debug");
+    EXPECT_EQ(tpl.parse(map), "B-B-end");
+}
+
 //
 // Test Elif statement blocks
 //
@@ -855,6 +960,1684 @@ TEST_F(TempletParserTest, ForLoopListOfMapsOfLists) {
     EXPECT_EQ(tpl.parse(map), "John,Jane,Mark,Mary,");
 }
 
+TEST_F(TempletParserTest, LazyValueNotComputedInFalseBranch) {
+    int calls = 0;
+    map["report"] = make_lazy(types::DataType::String, [&calls]{
+        ++calls;
+        return make_data("expensive");
+    });
+
+    tpl.setTemplate("{% if show %}{$ report }{% endif %}");
+    EXPECT_EQ(tpl.parse(map), "");
+    EXPECT_EQ(calls, 0);
+
+    map["show"] = make_data("true");
+    tpl.setTemplate("{% if show %}{$ report } {$ report }{% endif %}");
+    EXPECT_EQ(tpl.parse(map), "expensive expensive");
+    EXPECT_EQ(calls, 1);
+}
+
+TEST_F(TempletParserTest, LazyValueComputedPerRender) {
+    int calls = 0;
+    map["count"] = make_lazy(types::DataType::String, [&calls]{
+        return make_data(std::to_string(++calls));
+    });
+
+    tpl.setTemplate("{$ count }{% if count %},{$ count }{% endif %}");
+    EXPECT_EQ(tpl.parse(map), "1,1");
+    EXPECT_EQ(tpl.parse(map), "2,2");
+    EXPECT_EQ(tpl.update(map, {"count"}), "3,3");
+
+    std::ostringstream os;
+    tpl.render(map, os);
+    EXPECT_EQ(os.str(), "4,4");
+    EXPECT_EQ(calls, 4);
+}
+
+TEST_F(TempletParserTest, LazyListAndMap) {
+    map["users"] = make_lazy(types::DataType::List, []{
+        return make_data({"John", "Jane"});
+    });
+    map["config"] = make_lazy(types::DataType::Mapper, []{
+        DataMap config;
+        config["hostname"] = make_data("localhost");
+        return make_data(std::move(config));
+    });
+
+    tpl.setTemplate("{% for users as user %}{$ user },{% endfor %}{$ config.hostname }");
+    EXPECT_EQ(tpl.parse(map), "John,Jane,localhost");
+}
+
+TEST_F(TempletParserTest, NumberValues) {
+    map["count"] = make_data(3);
+    map["price"] = make_data(9.99);
+    map["sizes"] = make_data(DataVector{make_data(1), make_data(2)});
+
+    tpl.setTemplate("{$ count } items at {$ price }: {% for sizes as size %}{$ size },{% endfor %}");
+    EXPECT_EQ(tpl.parse(map), "3 items at 9.99: 1,2,");
+}
+
+TEST_F(TempletParserTest, ForLoopTable) {
+    map["servers"] = make_table({"name", "ip"}, {
+        {"stream-server", "192.168.101.1"},
+        {"game-server", "192.168.101.100"}
+    });
+
+    tpl.setTemplate("{% for servers as server %}{$ server.ip },{$ server.name }<br>{% endfor %}");
+    EXPECT_EQ(tpl.parse(map), "192.168.101.1,stream-server<br>192.168.101.100,game-server<br>");
+}
+
+TEST_F(TempletParserTest, TableArrayAccess) {
+    map["servers"] = make_table({"name", "ip"}, {
+        {"stream-server", "192.168.101.1"},
+        {"game-server", "192.168.101.100"}
+    });
+
+    tpl.setTemplate("{$ servers[1].name } {$ servers[2].name } {$ servers[0].port }");
+    EXPECT_EQ(tpl.parse(map), "game-server  ");
+}
+
+TEST_F(TempletParserTest, ForLoopTableInnerLoop) {
+    map["servers"] = make_table({"name"}, {{"a"}, {"b"}});
+
+    tpl.setTemplate("{% for servers as x %}{% for servers as y %}{$ x.name }{$ y.name },{% endfor %}{% endfor %}");
+    EXPECT_EQ(tpl.parse(map), "aa,ab,ba,bb,");
+}
+
+TEST(MakeDataHelperTest, StringListToDataPtr) {
+    // make_data keeps making a DataList, the compact list has its own factory
+    EXPECT_NE(dynamic_cast<const types::DataList*>(make_data(std::vector<std::string>{"a"}).get()), nullptr);
+    EXPECT_NE(dynamic_cast<const types::DataList*>(make_data({"a", "b"}).get()), nullptr);
+
+    DataPtr res = make_string_list({"John", "Jane"});
+    EXPECT_NE(dynamic_cast<const types::DataStringList*>(res.get()), nullptr);
+    ASSERT_EQ(res->getList().size(), 2);
+    EXPECT_EQ(res->getList()[1]->getValue(), "Jane");
+
+    Templet tpl("{% for users as user %}{$ user },{% endfor %}{$ users[1] }");
+    EXPECT_EQ(tpl.parse(DataMap{{"users", res}}), "John,Jane,Jane");
+}
+
+TEST(MakeDataHelperTest, TableToDataPtr) {
+    DataPtr res = make_table({"name", "ip"}, {{"stream-server", "192.168.101.1"}});
+
+    const DataVector& rows = res->getList();
+    ASSERT_EQ(rows.size(), 1);
+    EXPECT_EQ(rows[0]->getMap().at("ip")->getValue(), "192.168.101.1");
+
+    ASSERT_THROW(make_table({"name", "ip"}, {{"stream-server"}}), std::runtime_error);
+}
+
+TEST_F(TempletParserTest, DataBuilder) {
+    std::unique_ptr<DataBuilder> builder(new DataBuilder(256));
+
+    DataVector servers;
+    std::string expected;
+    for(int i = 0; i < 20; ++i) {
+        expected += "server" + std::to_string(i) + ":0.5,";
+        DataMap server;
+        server["id"] = builder->make(i);
+        server["name"] = builder->make("server");
+        server["load"] = builder->make(0.5);
+        servers.push_back(builder->make(std::move(server)));
+    }
+    map["servers"] = builder->make(std::move(servers));
+    map["users"] = builder->make(std::vector<std::string>{"John", "Jane"});
+    map["names"] = builder->makeStringList({"Bob", "Ann"});
+    EXPECT_GT(builder->arena().reserved(), 256);
+
+    // The data keeps the arena alive
+    builder.reset();
+
+    tpl.setTemplate("{% for servers as s %}{$ s.name }{$ s.id }:{$ s.load },{% endfor %}"
+                    "{% for users as user %}{$ user }{% endfor %}"
+                    "{% for names as name %}{$ name }{% endfor %}");
+    EXPECT_EQ(tpl.parse(map), expected + "JohnJaneBobAnn");
+}
+
+TEST_F(TempletParserTest, DataBuilderLargeUnsigned) {
+    DataBuilder builder;
+    map["max"] = builder.make(std::numeric_limits<unsigned long long>::max());
+    map["fits"] = builder.make(static_cast<unsigned long long>(std::numeric_limits<long long>::max()));
+    EXPECT_EQ(map["fits"]->type(), types::DataType::Integer);
+
+    tpl.setTemplate("{$ max } {$ fits }");
+    EXPECT_EQ(tpl.parse(map), "18446744073709551615 9223372036854775807");
+}
+
+//
+// Tests for streams
+//
+
+class CountingCursor : public DataCursor {
+private:
+    int _count;
+    int _pos {0};
+    DataPtr _item;
+
+public:
+    CountingCursor(int count) : _count(count) {}
+
+    const types::Data* next() override {
+        if(_pos == _count) {
+            return nullptr;
+        }
+        _item = make_data(++_pos);
+        return _item.get();
+    }
+};
+
+TEST_F(TempletParserTest, ForLoopStream) {
+    map["numbers"] = make_stream([]{
+        return mylib::make_unique<CountingCursor>(3);
+    });
+
+    tpl.setTemplate("{% for numbers as n %}{$ n },{% endfor %}");
+    EXPECT_EQ(tpl.parse(map), "1,2,3,");
+
+    // Each traversal gets a new cursor
+    tpl.setTemplate("{% for numbers as n %}{% for numbers as m %}{$ m }{% endfor %},{% endfor %}");
+    EXPECT_EQ(tpl.parse(map), "123,123,123,");
+}
+
+TEST_F(TempletParserTest, StreamArrayAccess) {
+    map["numbers"] = make_stream([]{
+        return mylib::make_unique<CountingCursor>(3);
+    });
+
+    tpl.setTemplate("{$ numbers[0] }");
+    EXPECT_EQ(tpl.parse(map), "");
+}
+
+TEST_F(TempletParserTest, LoopInvariantBlocks) {
+    int traversals = 0;
+    map["numbers"] = make_stream([&traversals]{
+        ++traversals;
+        return mylib::make_unique<CountingCursor>(3);
+    });
+    map["site"] = make_data(DataMap{{"name", make_data("site")}});
+    map["users"] = make_data({"John", "Jane"});
+
+    // The inner loop doesn't read user, so it's traversed once
+    tpl.setTemplate("{% for users as user %}<{$ site.name }>{% for numbers as n %}{$ n }{% endfor %}"
+                    "{% if user %}{$ user }{% endif %};{% endfor %}");
+    EXPECT_EQ(tpl.parse(map), "<site>123John;<site>123Jane;");
+    EXPECT_EQ(traversals, 1);
+
+    traversals = 0;
+    tpl.setTemplate("{% for numbers as n %}{% for numbers as m %}{$ m }{% endfor %},{% endfor %}");
+    EXPECT_EQ(tpl.parse(map), "123,123,123,");
+    EXPECT_EQ(traversals, 2);
+
+    traversals = 0;
+    tpl.setTemplate("{% for users as user %}{% for numbers as n %}{$ user }{$ n }{% endfor %};{% endfor %}");
+    EXPECT_EQ(tpl.parse(map), "John1John2John3;Jane1Jane2Jane3;");
+    EXPECT_EQ(traversals, 2);
+}
+
+class CountingMap : public types::Data {
+private:
+    DataMap _values;
+
+public:
+    mutable int lookups {0};
+
+    CountingMap(DataMap values) : _values(std::move(values)) {}
+
+    bool empty() const override {
+        return _values.empty();
+    }
+
+    const types::Data* getItem(const std::string& key, DataPtr& /*holder*/) const override {
+        ++lookups;
+        const auto it = _values.find(key);
+        return it == _values.cend() ? nullptr : it->second.get();
+    }
+
+    types::DataType type() const override {
+        return types::DataType::Mapper;
+    }
+};
+
+TEST_F(TempletParserTest, RepeatedPathsAreResolvedOnce) {
+    const auto user = std::make_shared<CountingMap>(DataMap{{"name", make_data("John")}});
+    const auto first = std::make_shared<CountingMap>(DataMap{{"id", make_data(1)}});
+    const auto second = std::make_shared<CountingMap>(DataMap{{"id", make_data(2)}});
+    map["user"] = user;
+    map["items"] = make_data(DataVector{first, second});
+
+    tpl.setTemplate("{$ user.name }|{% if user.name %}{$ user.name }{% endif %}|"
+                    "{% for items as item %}{$ item.id }{$ user.name }{$ item.id };{% endfor %}"
+                    "{$ user.missing }{$ user.missing }");
+    EXPECT_EQ(tpl.parse(map), "John|John|1John1;2John2;");
+    EXPECT_EQ(user->lookups, 2);
+    // Once per element
+    EXPECT_EQ(first->lookups, 1);
+    EXPECT_EQ(second->lookups, 1);
+
+    // A name that's missing at the top level and bound by a loop
+    user->lookups = 0;
+    tpl.setTemplate("{$ item.id }{% for items as item %}{$ item.id }{% endfor %}{$ item.id }");
+    EXPECT_EQ(tpl.parse(map), "12");
+}
+
+//
+// Tests for incremental updates
+//
+
+std::string validation_error(std::string text) {
+    Templet tpl(std::move(text));
+    try {
+        tpl.validate();
+    }
+    catch(const std::exception& ex) {
+        return ex.what();
+    }
+    return "";
+}
+
+TEST_F(TempletParserTest, ValidateStructure) {
+    EXPECT_EQ(validation_error("Hello\n  {% if a %}world"),
+              "Line 2, column 3: IF statements must be closed with ENDIF");
+    EXPECT_EQ(validation_error("{% if a %}{% for xs as x %}{% endif %}{% endfor %}"),
+              "Line 1, column 28: ENDIF statements cannot close a FOR statement");
+    EXPECT_EQ(validation_error("{% if a %}{% endif %}\n{% endfor %}"),
+              "Line 2, column 1: ENDFOR statements cannot be declared without a preceding FOR statement");
+    EXPECT_EQ(validation_error("{% for xs as x %}{% elif a %}{% endfor %}"),
+              "Line 1, column 18: ELIF statements cannot be declared without a preceding IF statement");
+    EXPECT_EQ(validation_error("{% if a %}{% else %}{% else %}{% endif %}"),
+              "Line 1, column 21: ELSE statements cannot be declared without a preceding IF or ELIF statement");
+    EXPECT_EQ(validation_error("{% for xs as x %}\n{% for ys as x %}{% endfor %}{% endfor %}"),
+              "Line 2, column 1: For expression alias name collides with an existing name");
+    EXPECT_EQ(validation_error("{% for x as x %}{% endfor %}"),
+              "Line 1, column 1: For expression alias name collides with an existing name");
+    EXPECT_EQ(validation_error("ab{$ a&b }"),
+              "Line 1, column 3: Variable tag name contains invalid characters");
+    EXPECT_EQ(validation_error("{% for xs into x %}{% endfor %}"),
+              "Line 1, column 1: Unrecognized for expression syntax");
+    tpl.setTemplate("{% for xs into x %}{% endfor %}");
+    ASSERT_THROW(tpl.validate(), templet::exception::ExpressionSyntaxError);
+
+    EXPECT_EQ(validation_error("{% for xs as x %}{% if x %}{$ x }{% elif y %}-{% else %}{% for x.ys as y %}"
+                               "{% endfor %}{% endif %}{% endfor %}"), "");
+    // Without validation these are accepted
+    tpl.setTemplate("{% if a %}A{% endfor %}B");
+    EXPECT_EQ(tpl.parse(map), "B");
+}
+
+TEST_F(TempletParserTest, ValidatedTemplateRender) {
+    map["users"] = make_data({"John", "Jane"});
+    tpl.setTemplate("{% for users as user %}{% if admin %}*{% endif %}{$ user },{% endfor %}");
+    tpl.validate();
+    EXPECT_EQ(tpl.parse(map), "John,Jane,");
+
+    auto chunks = tpl.chunks(map, 1);
+    std::string output;
+    std::string chunk;
+    while(chunks.next(chunk)) {
+        output += chunk;
+    }
+    EXPECT_EQ(output, "John,Jane,");
+
+    // An alias that collides with a value throws as without validation
+    map["user"] = make_data("root");
+    ASSERT_THROW(tpl.parse(map), templet::exception::InvalidTagError);
+    tpl.setTemplate("{% for users as user %}{% if admin %}*{% endif %}{$ user },{% endfor %}");
+    ASSERT_THROW(tpl.parse(map), templet::exception::InvalidTagError);
+}
+
+TEST_F(TempletParserTest, UpdateOnlyChangedBlocks) {
+    map["first_name"] = make_data("john");
+    map["last_name"] = make_data("doe");
+
+    tpl.setTemplate("hello, {$first_name} {$last_name}");
+    EXPECT_EQ(tpl.parse(map), "hello, john doe");
+
+    map["first_name"] = make_data("jane");
+    map["last_name"] = make_data("roe");
+
+    // last_name is not reported as changed so its old output is kept
+    EXPECT_EQ(tpl.update(map, {"first_name"}), "hello, jane doe");
+    EXPECT_EQ(tpl.update(map, {"last_name"}), "hello, jane roe");
+    EXPECT_EQ(tpl.result(), "hello, jane roe");
+}
+
+TEST_F(TempletParserTest, UpdateNestedBlocks) {
+    map["users"] = make_data({"John", "Jane"});
+
+    tpl.setTemplate("{% if show %}{% for users as user %}{$ user },{% endfor %}{% endif %}!");
+    EXPECT_EQ(tpl.parse(map), "!");
+
+    map["show"] = make_data("true");
+    EXPECT_EQ(tpl.update(map, {"show"}), "John,Jane,!");
+
+    map["users"] = make_data({"Mark"});
+    EXPECT_EQ(tpl.update(map, {"users"}), "Mark,!");
+}
+
+TEST_F(TempletParserTest, UpdateWithoutPreviousResult) {
+    map["name"] = make_data("john");
+
+    tpl.setTemplate("hello {$name}");
+    std::vector<Change> diff;
+    EXPECT_EQ(tpl.update(map, {}, &diff), "hello john");
+    ASSERT_EQ(diff.size(), 1);
+    EXPECT_EQ(diff[0].offset, 0);
+    EXPECT_EQ(diff[0].length, 0);
+    EXPECT_EQ(diff[0].text, "hello john");
+}
+
+TEST_F(TempletParserTest, UpdateDiff) {
+    map["first_name"] = make_data("john");
+    map["last_name"] = make_data("doe");
+
+    tpl.setTemplate("hello, {$first_name} {$last_name}");
+    tpl.parse(map);
+
+    map["last_name"] = make_data("roe");
+    std::vector<Change> diff;
+    EXPECT_EQ(tpl.update(map, {"first_name", "last_name"}, &diff), "hello, john roe");
+    ASSERT_EQ(diff.size(), 1);
+    EXPECT_EQ(diff[0].offset, 12);
+    EXPECT_EQ(diff[0].length, 3);
+    EXPECT_EQ(diff[0].text, "roe");
+}
+
+//
+// Tests for snapshots
+//
+
+TEST_F(TempletParserTest, SnapshotRender) {
+    DataVector servers;
+    for(int i = 0; i < 3; ++i) {
+        DataMap server;
+        server["id"] = make_data(i);
+        server["name"] = make_data("server");
+        server["load"] = make_data(0.25);
+        servers.push_back(make_data(server));
+    }
+    map["servers"] = make_data(servers);
+    map["users"] = make_data({"John", "Jane"});
+    map["title"] = make_data("Servers");
+    map["empty"] = make_data("");
+
+    tpl.setTemplate("{$ title }:{% for servers as s %}{$ s.name }{$ s.id }={$ s.load },{% endfor %}"
+                    "{% for users as user %}{$ user }{% endfor %}{% if empty %}!{% endif %}");
+    const auto expected = tpl.parse(map);
+
+    std::ostringstream image;
+    save_snapshot(map, image);
+    const auto snapshot = Snapshot::fromImage(image.str());
+    EXPECT_EQ(snapshot->size(), image.str().size());
+    EXPECT_EQ(tpl.parse(snapshot->values()), expected);
+
+    const auto& servers2 = snapshot->values().at("servers");
+    EXPECT_EQ(servers2->type(), types::DataType::List);
+    EXPECT_EQ(servers2->getList().size(), 3);
+    EXPECT_EQ(servers2->getList()[1]->getMap().at("id")->type(), types::DataType::Integer);
+    EXPECT_EQ(servers2->getList()[1]->getMap().at("id")->getValue(), "1");
+}
+
+TEST_F(TempletParserTest, SnapshotSharedBetweenThreads) {
+    DataMap config;
+    config["host"] = make_data("localhost");
+    map["config"] = make_data(config);
+    map["users"] = make_data({"John", "Jane"});
+    map["title"] = make_data("Users");
+
+    std::ostringstream image;
+    save_snapshot(map, image);
+    const auto snapshot = Snapshot::fromImage(image.str());
+
+    const std::string text = "{$ title }@{$ config.host }:{% for users as user %}{$ user },{% endfor %}{$ users[1] }";
+    std::vector<std::string> results(4);
+    std::vector<std::thread> threads;
+    for(auto& result : results) {
+        threads.emplace_back([&snapshot, &text, &result]{
+            Templet local(text);
+            for(int i = 0; i < 100; ++i) {
+                result = local.parse(snapshot->values());
+                result += snapshot->values().at("title")->getValue();
+                result += snapshot->values().at("config")->getMap().at("host")->getValue();
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(const auto& result : results) {
+        EXPECT_EQ(result, "Users@localhost:John,Jane,JaneUserslocalhost");
+    }
+}
+
+TEST_F(TempletParserTest, SnapshotFile) {
+    map["name"] = make_data("john");
+
+    {
+        std::ofstream out {"snapshot_test.snap", std::ios::binary};
+        save_snapshot(map, out);
+    }
+    const auto snapshot = Snapshot::fromFile("snapshot_test.snap");
+    std::remove("snapshot_test.snap");
+
+    tpl.setTemplate("hello {$ name }");
+    EXPECT_EQ(tpl.parse(snapshot->values()), "hello john");
+}
+
+TEST_F(TempletParserTest, SnapshotErrors) {
+    ASSERT_THROW(Snapshot::fromImage("not a snapshot image"), std::runtime_error);
+    ASSERT_THROW(Snapshot::fromFile("missing.snap"), std::runtime_error);
+
+    std::ostringstream image;
+    save_snapshot(map, image);
+    ASSERT_THROW(Snapshot::fromImage(image.str().substr(0, image.str().size() - 1)), std::runtime_error);
+
+    map["numbers"] = make_stream([]{
+        return mylib::make_unique<CountingCursor>(3);
+    });
+    ASSERT_THROW(save_snapshot(map, image), std::runtime_error);
+}
+
+//
+// Tests for JSON documents
+//
+
+TEST_F(TempletParserTest, JsonRender) {
+    const auto json = JsonDocument::parse(R"({
+        "title": "Servers",
+        "servers": [
+            {"name": "alpha", "id": 1, "load": 0.25},
+            {"name": "beta", "id": -2, "load": 1e3}
+        ],
+        "owner": {"name": "John \"Johnny\" Doe", "city": "Z\u00fcrich \ud83d\ude00"},
+        "enabled": true,
+        "disabled": false,
+        "missing": null,
+        "tags": []
+    })");
+
+    tpl.setTemplate("{$ title }:{% for servers as s %}{$ s.name }{$ s.id }={$ s.load },{% endfor %}"
+                    "{$ owner.name }/{$ owner.city }"
+                    "{% if enabled %}+{% endif %}{% if disabled %}-{% endif %}{% if missing %}-{% endif %}"
+                    "{% for tags as tag %}{$ tag }{% endfor %}");
+    EXPECT_EQ(tpl.parse(json->values()),
+              "Servers:alpha1=0.25,beta-2=1e3,John \"Johnny\" Doe/Z\xc3\xbcrich \xf0\x9f\x98\x80+");
+
+    const auto& servers = json->values().at("servers");
+    EXPECT_EQ(servers->type(), types::DataType::List);
+    ASSERT_EQ(servers->getList().size(), 2);
+    EXPECT_EQ(servers->getList()[0]->getMap().at("id")->type(), types::DataType::Integer);
+    EXPECT_EQ(servers->getList()[1]->getMap().at("load")->type(), types::DataType::Float);
+    EXPECT_EQ(json->values().count("disabled"), 0);
+}
+
+TEST_F(TempletParserTest, JsonSharedBetweenThreads) {
+    const auto json = JsonDocument::parse(R"({"title": "Users", "owner": {"name": "J\u00f6rg"},
+                                              "users": [{"name": "John"}, {"name": "Jane"}]})");
+
+    const std::string text = "{$ title }:{$ owner.name }:{% for users as user %}{$ user.name },{% endfor %}"
+                             "{$ users[1].name }";
+    std::vector<std::string> results(4);
+    std::vector<std::thread> threads;
+    for(auto& result : results) {
+        threads.emplace_back([&json, &text, &result]{
+            Templet local(text);
+            for(int i = 0; i < 100; ++i) {
+                result = local.parse(json->values());
+                result += json->values().at("owner")->getMap().at("name")->getValue();
+                result += json->values().at("users")->getList()[0]->getMap().at("name")->getValue();
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(const auto& result : results) {
+        EXPECT_EQ(result, "Users:J\xc3\xb6rg:John,Jane,JaneJ\xc3\xb6rgJohn");
+    }
+}
+
+TEST_F(TempletParserTest, JsonArrayAccess) {
+    const auto json = JsonDocument::parse(R"({"a": {"b": [0, 1, 2, {"c": "found"}]}})");
+
+    tpl.setTemplate("{$ a.b[3].c }");
+    EXPECT_EQ(tpl.parse(json->values()), "found");
+    tpl.setTemplate("{$ a.b[0] }{$ a.b[2] }{$ a.b[4] }");
+    EXPECT_EQ(tpl.parse(json->values()), "02");
+}
+
+TEST_F(TempletParserTest, JsonNullAndFalseAreNotSet) {
+    const auto json = JsonDocument::parse(R"({"obj": {"n": null, "f": false, "t": true, "z": 0},
+                                              "arr": [null, false, true, 0]})");
+
+    // Members and elements follow the same rule
+    tpl.setTemplate("{% if obj.n %}n{% endif %}{% if obj.f %}f{% endif %}"
+                    "{% if obj.t %}t{% endif %}{% if obj.z %}z{% endif %}|"
+                    "{% if arr[0] %}n{% endif %}{% if arr[1] %}f{% endif %}"
+                    "{% if arr[2] %}t{% endif %}{% if arr[3] %}z{% endif %}|"
+                    "{% for arr as item %}[{$ item }]{% endfor %}");
+    EXPECT_EQ(tpl.parse(json->values()), "tz|tz|[][][true][0]");
+}
+
+TEST_F(TempletParserTest, JsonErrors) {
+    ASSERT_THROW(JsonDocument::parse(""), std::runtime_error);
+    ASSERT_THROW(JsonDocument::parse("{\"a\": }"), std::runtime_error);
+    ASSERT_THROW(JsonDocument::parse("{\"a\": 1,}"), std::runtime_error);
+    ASSERT_THROW(JsonDocument::parse("[01]"), std::runtime_error);
+    ASSERT_THROW(JsonDocument::parse("\"\\x\""), std::runtime_error);
+    ASSERT_THROW(JsonDocument::parse("[1] 2"), std::runtime_error);
+    ASSERT_THROW(JsonDocument::parse(std::string(1000, '[') + std::string(1000, ']')), std::runtime_error);
+
+    // A top-level value that isn't an object can't be rendered
+    const auto json = JsonDocument::parse(" [1, 2] ");
+    EXPECT_EQ(json->root().type(), types::DataType::List);
+    ASSERT_THROW(json->values(), std::runtime_error);
+}
+
+//
+// Tests for row streams
+//
+
+TEST_F(TempletParserTest, RenderToStream) {
+    map["name"] = make_data("john");
+
+    tpl.setTemplate("hello {$ name }");
+    std::ostringstream os;
+    tpl.render(map, os);
+    EXPECT_EQ(os.str(), "hello john");
+    EXPECT_EQ(tpl.result(), "");
+}
+
+TEST_F(TempletParserTest, CsvStream) {
+    map["rows"] = make_csv_stream([]{
+        return std::unique_ptr<std::istream>(new std::istringstream(
+            "name,city\r\n"
+            "John,Helsinki\r\n"
+            "\r\n"
+            "\"Doe, Jane\",\"New\nYork \"\"NY\"\"\"\n"
+            "Mark\n"));
+    });
+
+    tpl.setTemplate("{% for rows as row %}{$ row.name }:{$ row.city }|{% endfor %}");
+    EXPECT_EQ(tpl.parse(map), "John:Helsinki|Doe, Jane:New\nYork \"NY\"|Mark:|");
+
+    // Each traversal opens the input again
+    EXPECT_EQ(tpl.parse(map), "John:Helsinki|Doe, Jane:New\nYork \"NY\"|Mark:|");
+
+    const auto cursor = map["rows"]->getCursor();
+    const auto row = cursor->next();
+    ASSERT_NE(row, nullptr);
+    EXPECT_EQ(row->getMap().size(), 2);
+    EXPECT_EQ(&row->getMap(), &cursor->next()->getMap());
+    EXPECT_EQ(row->getMap().at("city")->getValue(), "New\nYork \"NY\"");
+}
+
+TEST_F(TempletParserTest, CsvStreamErrors) {
+    map["rows"] = make_csv_stream([]{
+        return std::unique_ptr<std::istream>(new std::istringstream("a;b\n1;2;3\n"));
+    }, ';');
+
+    tpl.setTemplate("{% for rows as row %}{$ row.a }{% endfor %}");
+    ASSERT_THROW(tpl.parse(map), std::runtime_error);
+
+    // Extra fields must not reallocate the fields the row refers to
+    map["rows"] = make_csv_stream([]{
+        return std::unique_ptr<std::istream>(new std::istringstream("a;b\n1;2\n1;2;3;4;5;6;7;8;9;10;11;12\n"));
+    }, ';');
+    tpl.setTemplate("{% for rows as row %}{$ row.a }{$ row.b }{% endfor %}");
+    std::ostringstream os;
+    ASSERT_THROW(tpl.render(map, os), std::runtime_error);
+    EXPECT_EQ(os.str(), "12");
+
+    map["rows"] = make_csv_stream([]{
+        return std::unique_ptr<std::istream>(new std::istringstream("a;b;a\n1;2;3\n"));
+    }, ';');
+    ASSERT_THROW(tpl.parse(map), std::runtime_error);
+
+    map["rows"] = make_csv_stream("missing.csv");
+    ASSERT_THROW(tpl.parse(map), std::runtime_error);
+}
+
+TEST_F(TempletParserTest, NdjsonStream) {
+    map["rows"] = make_ndjson_stream([]{
+        return std::unique_ptr<std::istream>(new std::istringstream(
+            "{\"name\": \"John\", \"tags\": [\"a\", \"b\"]}\n"
+            "\n"
+            "{\"name\": \"Jane\", \"tags\": [], \"admin\": true}\n"));
+    });
+
+    tpl.setTemplate("{% for rows as row %}{$ row.name }{% if row.admin %}*{% endif %}:"
+                    "{% for row.tags as tag %}{$ tag }{% endfor %}|{% endfor %}");
+    std::ostringstream os;
+    tpl.render(map, os);
+    EXPECT_EQ(os.str(), "John:ab|Jane*:|");
+
+    map["rows"] = make_ndjson_stream([]{
+        return std::unique_ptr<std::istream>(new std::istringstream("{}\n{\"name\": }\n"));
+    });
+    ASSERT_THROW(tpl.parse(map), std::runtime_error);
+}
+
+//
+// Tests for struct binding
+//
+
+namespace {
+
+struct Location {
+    std::string city;
+    double latitude;
+};
+
+class Server {
+private:
+    std::string _name;
+
+public:
+    Server(std::string name) : _name(std::move(name)) {}
+
+    const std::string& name() const {
+        return _name;
+    }
+
+    int id {0};
+    bool online {false};
+    unsigned long long traffic {0};
+    Location location;
+    std::vector<std::string> tags;
+    std::vector<int> ports;
+};
+
+} // unnamed namespace
+
+namespace templet {
+
+template <>
+struct Binding<Location> {
+    static void fields(binding::Fields<Location>& f) {
+        f("city", &Location::city)("latitude", &Location::latitude);
+    }
+};
+
+template <>
+struct Binding<Server> {
+    static void fields(binding::Fields<Server>& f) {
+        f("name", &Server::name)
+         ("id", &Server::id)
+         ("online", &Server::online)
+         ("traffic", &Server::traffic)
+         ("location", &Server::location)
+         ("tags", &Server::tags)
+         ("ports", &Server::ports);
+    }
+};
+
+} // namespace templet
+
+TEST_F(TempletParserTest, BindStruct) {
+    std::vector<Server> servers {Server("alpha"), Server("beta")};
+    servers[0].id = 1;
+    servers[0].online = true;
+    servers[0].traffic = std::numeric_limits<unsigned long long>::max();
+    servers[0].location = Location{"Helsinki", 60.25};
+    servers[0].tags = {"db", "eu"};
+    servers[0].ports = {80, 443};
+    servers[1].id = 2;
+    servers[1].location = Location{"Tokyo", 35.5};
+
+    map["servers"] = make_binding(servers);
+    map["first"] = make_binding(servers[0]);
+
+    tpl.setTemplate("{% for servers as s %}{$ s.name }#{$ s.id }{% if s.online %}*{% endif %}"
+                    " {$ s.location.city }@{$ s.location.latitude }:"
+                    "{% for s.tags as tag %}{$ tag },{% endfor %}"
+                    "{% for s.ports as port %}{$ port },{% endfor %}|{% endfor %}{$ first.traffic }");
+    EXPECT_EQ(tpl.parse(map), "alpha#1* Helsinki@60.25:db,eu,80,443,|beta#2 Tokyo@35.5:|18446744073709551615");
+
+    // The objects are read when rendering, not when binding
+    servers[1].id = 3;
+    EXPECT_EQ(tpl.parse(map), "alpha#1* Helsinki@60.25:db,eu,80,443,|beta#3 Tokyo@35.5:|18446744073709551615");
+
+    const auto& first = map["first"]->getMap();
+    EXPECT_EQ(first.at("name")->getValue(), "alpha");
+    EXPECT_EQ(first.at("id")->type(), types::DataType::Integer);
+    EXPECT_EQ(first.at("traffic")->type(), types::DataType::String);
+    EXPECT_EQ(map["servers"]->getList().size(), 2);
+    EXPECT_EQ(map["servers"]->getList()[1]->getMap().count("online"), 0);
+}
+
+TEST_F(TempletParserTest, BindingSharedBetweenThreads) {
+    std::vector<Server> servers {Server("alpha"), Server("beta")};
+    servers[0].id = 1;
+    servers[0].location = Location{"Helsinki", 60.25};
+    servers[1].id = 2;
+    servers[1].location = Location{"Tokyo", 35.5};
+    map["servers"] = make_binding(servers);
+    map["first"] = make_binding(servers[0]);
+
+    const std::string text = "{$ first.name }:{% for servers as s %}{$ s.id }@{$ s.location.city },{% endfor %}"
+                             "{$ servers[1].name }";
+    std::vector<std::string> results(4);
+    std::vector<std::thread> threads;
+    for(auto& result : results) {
+        threads.emplace_back([this, &text, &result]{
+            Templet local(text);
+            for(int i = 0; i < 100; ++i) {
+                result = local.parse(map);
+                result += map.at("first")->getMap().at("name")->getValue();
+            }
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(const auto& result : results) {
+        EXPECT_EQ(result, "alpha:1@Helsinki,2@Tokyo,betaalpha");
+    }
+}
+
+//
+// Tests for generated code
+//
+
+// Generated by templetc from templates/ into compiled_templates.cpp, in name
+// order. The parser_ templates are the ones from the TempletParserTest cases.
+#define COMPILED_TEMPLATES(X) \
+    X(branches) \
+    X(escapes) \
+    X(hello) \
+    X(loops) \
+    X(misplaced) \
+    X(nested_branches) \
+    X(parser_array_access) \
+    X(parser_array_access_ignore_leading_zero) \
+    X(parser_array_access_invalid_format) \
+    X(parser_array_access_invalid_format_2) \
+    X(parser_array_access_invalid_format_3) \
+    X(parser_array_access_invalid_format_4) \
+    X(parser_array_access_invalid_numbers) \
+    X(parser_array_access_invalid_numbers_2) \
+    X(parser_array_access_out_of_range) \
+    X(parser_array_access_out_of_range_negative) \
+    X(parser_array_access_string) \
+    X(parser_array_access_string_2) \
+    X(parser_bind_struct) \
+    X(parser_csv_stream) \
+    X(parser_csv_stream_errors) \
+    X(parser_csv_stream_errors_2) \
+    X(parser_data_builder) \
+    X(parser_data_builder_large_unsigned) \
+    X(parser_dot_notation_value) \
+    X(parser_dot_notation_value_array_list) \
+    X(parser_dot_notation_value_array_list_without_name) \
+    X(parser_dot_notation_value_array_list_without_name_2) \
+    X(parser_dot_notation_value_array_map) \
+    X(parser_dot_notation_value_multi) \
+    X(parser_dot_notation_value_multi_array) \
+    X(parser_dot_notation_value_multi_array_2) \
+    X(parser_dot_notation_value_multi_array_3) \
+    X(parser_dot_notation_value_multi_array_4) \
+    X(parser_dot_notation_value_multi_array_5) \
+    X(parser_dot_notation_without_dots) \
+    X(parser_elif_block) \
+    X(parser_elif_block_multiple) \
+    X(parser_elif_without_if) \
+    X(parser_else_without_if_or_elif) \
+    X(parser_empty_template) \
+    X(parser_ends_with_incomplete_tag) \
+    X(parser_ends_with_incomplete_tag_2) \
+    X(parser_ends_with_incomplete_tag_3) \
+    X(parser_ends_with_tag_opener) \
+    X(parser_ends_with_tag_opener_2) \
+    X(parser_ends_with_tag_opener_3) \
+    X(parser_for_loop_alias_name_collision) \
+    X(parser_for_loop_inner_for_loop) \
+    X(parser_for_loop_list) \
+    X(parser_for_loop_list_array_index) \
+    X(parser_for_loop_list_array_multi_index) \
+    X(parser_for_loop_list_array_multi_index_2) \
+    X(parser_for_loop_list_dot_notation) \
+    X(parser_for_loop_list_of_maps_of_lists) \
+    X(parser_for_loop_map) \
+    X(parser_for_loop_stream) \
+    X(parser_for_loop_stream_2) \
+    X(parser_for_loop_table_inner_loop) \
+    X(parser_if_block_nested_dupe_name) \
+    X(parser_if_block_text_after_endif) \
+    X(parser_if_dot_notation) \
+    X(parser_if_dot_notation_2) \
+    X(parser_if_dot_notation_with_arrays) \
+    X(parser_if_dot_notation_with_arrays_2) \
+    X(parser_if_dot_notation_with_arrays_end_index) \
+    X(parser_if_dot_notation_with_arrays_end_index_2) \
+    X(parser_if_else_block) \
+    X(parser_if_else_block_multiple_elses) \
+    X(parser_if_else_block_text_after_endif) \
+    X(parser_if_else_block_text_after_endif_2) \
+    X(parser_if_inside_elif) \
+    X(parser_if_inside_else) \
+    X(parser_if_inside_if) \
+    X(parser_if_value_tag_name_with_outer_space) \
+    X(parser_ignored_tag) \
+    X(parser_ignored_tag_2) \
+    X(parser_ignored_tag_3) \
+    X(parser_ignored_tag_4) \
+    X(parser_ignored_tag_5) \
+    X(parser_invalid_dot_notation_value) \
+    X(parser_invalid_dot_notation_value_2) \
+    X(parser_json_array_access) \
+    X(parser_json_array_access_2) \
+    X(parser_json_null_and_false_are_not_set) \
+    X(parser_json_render) \
+    X(parser_lazy_list_and_map) \
+    X(parser_lazy_value_computed_per_render) \
+    X(parser_lazy_value_not_computed_in_false_branch) \
+    X(parser_lazy_value_not_computed_in_false_branch_2) \
+    X(parser_lists_of_lists) \
+    X(parser_loop_invariant_blocks) \
+    X(parser_loop_invariant_blocks_2) \
+    X(parser_ndjson_stream) \
+    X(parser_number_values) \
+    X(parser_plain_text) \
+    X(parser_repeated_paths_are_resolved_once) \
+    X(parser_repeated_paths_are_resolved_once_2) \
+    X(parser_result) \
+    X(parser_snapshot_file) \
+    X(parser_snapshot_render) \
+    X(parser_stream_array_access) \
+    X(parser_table_array_access) \
+    X(parser_unrecognized_tag) \
+    X(parser_unrecognized_tag_2) \
+    X(parser_unset_if_block) \
+    X(parser_unset_unclosed_if_block) \
+    X(parser_unset_variables) \
+    X(parser_update_nested_blocks) \
+    X(parser_update_without_previous_result) \
+    X(parser_valid_if_value_tag_name) \
+    X(parser_valid_value_tag_name) \
+    X(parser_validate_structure) \
+    X(parser_validated_template_render) \
+    X(parser_value_tag_name_with_outer_space) \
+    X(paths) \
+    X(rows) \
+    X(unclosed)
+
+#define DECLARE_RENDER(name) void render_##name(std::ostream& os, const templet::DataMap& values);
+COMPILED_TEMPLATES(DECLARE_RENDER)
+#undef DECLARE_RENDER
+
+namespace {
+
+using RenderFunction = void (*)(std::ostream&, const templet::DataMap&);
+
+#define RENDER_ENTRY(name) {#name, render_##name},
+const std::vector<std::pair<std::string, RenderFunction>> compiledTemplates {
+    COMPILED_TEMPLATES(RENDER_ENTRY)
+};
+#undef RENDER_ENTRY
+
+std::vector<DataMap> compiledTemplateInputs() {
+    std::vector<DataMap> inputs(3);
+
+    DataMap server;
+    server["hostname"] = make_data("localhost");
+    inputs[1]["config"] = make_data(DataMap{{"server", make_data(server)}});
+    inputs[1]["first_name"] = make_data("John");
+    inputs[1]["last_name"] = make_data("Doe");
+    inputs[1]["debug"] = make_data("");
+    inputs[1]["is_world"] = make_data("true");
+    inputs[1]["users"] = make_data({"John", "Jane"});
+    DataVector servers;
+    for(int i = 0; i < 2; ++i) {
+        DataMap entry;
+        entry["name"] = make_data("server" + std::to_string(i));
+        entry["load"] = make_data(0.5 * i);
+        entry["tags"] = make_data({"db", "eu"});
+        servers.push_back(make_data(entry));
+    }
+    inputs[1]["servers"] = make_data(servers);
+    inputs[1]["rows"] = make_table({"name", "ip"}, {{"alpha", "10.0.0.1"}, {"beta", "10.0.0.2"}});
+
+    server["ip"] = make_data("127.0.0.1");
+    server.erase("hostname");
+    inputs[2]["config"] = make_data(DataMap{{"server", make_data(server)}});
+    inputs[2]["first_name"] = make_data(42);
+    inputs[2]["test"] = make_data("true");
+    inputs[2]["gravity"] = make_data("true");
+    inputs[2]["users"] = make_data(DataVector{});
+    inputs[2]["servers"] = make_data(DataVector{});
+    inputs[2]["rows"] = make_data(DataVector{});
+
+    // The data of the TempletParserTest cases
+    DataMap parser;
+    parser["first_name"] = make_data("john");
+    parser["last_name"] = make_data("doe");
+    parser["azAZ09-_"] = make_data("value");
+    parser["azAZ09_-"] = make_data("true");
+    parser["is_not_test"] = make_data("true");
+    parser["is_world"] = make_data("true");
+    parser["debug"] = make_data("true");
+    parser["test"] = make_data("true");
+    parser["modes"] = make_data({"1", "2"});
+    parser["name"] = make_data("john");
+    parser["show"] = make_data("true");
+    parser["report"] = make_lazy(types::DataType::String, []{ return make_data("expensive"); });
+    parser["count"] = make_data(3);
+    parser["price"] = make_data(9.99);
+    parser["sizes"] = make_data(DataVector{make_data(1), make_data(2)});
+    parser["max"] = make_data(std::numeric_limits<unsigned long long>::max());
+    parser["fits"] = make_data(static_cast<unsigned long long>(std::numeric_limits<long long>::max()));
+    parser["numbers"] = make_stream([]{ return mylib::make_unique<CountingCursor>(3); });
+    parser["site"] = make_data(DataMap{{"name", make_data("site")}});
+    parser["users"] = make_data({"John", "Jane"});
+    parser["title"] = make_data("Servers");
+    parser["empty"] = make_data("");
+    inputs.push_back(parser);
+
+    DataMap first;
+    first["ips"] = make_data({"192.168.101.1", "192.168.101.2", "192.168.101.3"});
+    first["hostname"] = make_data("game-server.localhost");
+    first["hostnames"] = make_data({"localhost", "game-server"});
+    DataMap second;
+    second["ips"] = make_data({"192.168.101.100", "192.168.101.101", "192.168.101.102"});
+    second["hostname"] = make_data("stream-server.localhost");
+    DataMap users;
+    users["active"] = make_data({"John", "Jane"});
+    users["inactive"] = make_data({"Mark", "Mary"});
+    DataVector groups;
+    groups.push_back(make_data(DataVector{make_data({"John", "Jane"}), make_data({"Mark", "Mary"})}));
+    parser.clear();
+    parser["items"] = make_data({"first", "second", "third"});
+    parser["item"] = make_data("hello world");
+    parser["config"] = make_data(DataMap{{"hostname", make_data("localhost")},
+                                         {"servers", make_data(DataVector{make_data(first), make_data(second)})}});
+    parser["server"] = make_data(first);
+    parser["users"] = make_data(users);
+    parser["groups"] = make_data(groups);
+    inputs.push_back(parser);
+
+    DataMap server1;
+    server1["ip"] = make_data("192.168.101.1");
+    server1["name"] = make_data("stream-server");
+    server1["users"] = make_data({"John", "Jane"});
+    DataMap server2;
+    server2["ip"] = make_data("192.168.101.100");
+    server2["name"] = make_data("game-server");
+    server2["users"] = make_data({"Mark", "Mary"});
+    parser.clear();
+    parser["items"] = make_data(DataVector{make_data({"one", "two", "three"}), make_data({"four", "five", "six"})});
+    parser["users"] = make_data(DataVector{make_data({"John", "Jane"}), make_data({"Mark", "Mary"})});
+    parser["servers"] = make_data(DataVector{make_data(server1), make_data(server2)});
+    parser["config"] = make_data(DataMap{{"server", make_data(server1)}});
+    inputs.push_back(parser);
+
+    parser.clear();
+    parser["servers"] = make_table({"name", "ip"}, {{"stream-server", "192.168.101.1"}, {"game-server", "192.168.101.100"}});
+    parser["user"] = make_data(DataMap{{"name", make_data("John")}});
+    parser["items"] = make_data(DataVector{make_data(DataMap{{"id", make_data(1)}}),
+                                           make_data(DataMap{{"id", make_data(2)}})});
+    parser["admin"] = make_data("true");
+    parser["rows"] = make_csv_stream([]{
+        return std::unique_ptr<std::istream>(new std::istringstream(
+            "name,city,a\r\n"
+            "John,Helsinki,1\r\n"
+            "\"Doe, Jane\",\"New\nYork \"\"NY\"\"\"\n"
+            "Mark\n"));
+    });
+    inputs.push_back(parser);
+
+    parser.clear();
+    parser["rows"] = make_ndjson_stream([]{
+        return std::unique_ptr<std::istream>(new std::istringstream(
+            "{\"name\": \"John\", \"tags\": [\"a\", \"b\"]}\n"
+            "{\"name\": \"Jane\", \"tags\": [], \"admin\": true}\n"));
+    });
+    static const std::vector<Server> bound = []{
+        std::vector<Server> result {Server("alpha"), Server("beta")};
+        result[0].id = 1;
+        result[0].online = true;
+        result[0].location = Location{"Helsinki", 60.25};
+        result[0].tags = {"db", "eu"};
+        result[0].ports = {80, 443};
+        return result;
+    }();
+    parser["servers"] = make_binding(bound);
+    parser["first"] = make_binding(bound[0]);
+    inputs.push_back(parser);
+
+    static const auto json = JsonDocument::parse(R"({
+        "title": "Servers",
+        "servers": [{"name": "alpha", "id": 1, "load": 0.25}, {"name": "beta", "id": -2, "load": 1e3}],
+        "owner": {"name": "John \"Johnny\" Doe", "city": "Z\u00fcrich"},
+        "enabled": true, "disabled": false, "missing": null, "tags": [],
+        "a": {"b": [0, 1, 2, {"c": "found"}]},
+        "obj": {"n": null, "f": false, "t": true, "z": 0},
+        "arr": [null, false, true, 0]
+    })");
+    inputs.push_back(json->values());
+
+    return inputs;
+}
+
+} // unnamed namespace
+
+TEST(CodeGeneratorTest, GeneratedFileIsUpToDate) {
+    std::vector<std::pair<std::string, std::string>> templates;
+    for(const auto& compiled : compiledTemplates) {
+        templates.emplace_back("render_" + compiled.first,
+                               helpers::FileReader::fromFile("templates/" + compiled.first + ".tpl"));
+    }
+
+    std::ostringstream os;
+    generate_cpp(templates, os);
+    EXPECT_EQ(os.str(), helpers::FileReader::fromFile("compiled_templates.cpp"));
+}
+
+TEST(CodeGeneratorTest, SameOutputAsInterpreter) {
+    for(const auto& values : compiledTemplateInputs()) {
+        for(const auto& compiled : compiledTemplates) {
+            Templet tpl(helpers::FileReader::fromFile("templates/" + compiled.first + ".tpl"));
+            std::string expected;
+            std::string error;
+            try {
+                expected = tpl.parse(values);
+            }
+            catch(const std::exception& ex) {
+                error = ex.what();
+            }
+
+            std::ostringstream os;
+            try {
+                compiled.second(os, values);
+                EXPECT_EQ(os.str(), expected) << compiled.first;
+                EXPECT_EQ(error, "") << compiled.first;
+            }
+            catch(const std::exception& ex) {
+                EXPECT_EQ(ex.what(), error) << compiled.first;
+            }
+        }
+    }
+}
+
+TEST(CodeGeneratorTest, InvalidInput) {
+    std::ostringstream os;
+    ASSERT_THROW(generate_cpp({{"1render", "hello"}}, os), std::runtime_error);
+    ASSERT_THROW(generate_cpp({{"render", "{% if foo&bar %}{% endif %}"}}, os), templet::exception::InvalidTagError);
+}
+
+TEST(CodeGeneratorTest, SameErrorsAsInterpreter) {
+    // The TempletParserTest templates that templetc rejects
+    const std::vector<std::string> sources {
+        "hello {% infloop %}world{% endinfloop %}",
+        "{$foo&bar}",
+        "{$foo bar}",
+        "{% if foo&bar %}",
+        "{% if foo bar %}",
+        "Users: {% for %}{$ user },{% endfor %}",
+        "Users: {% for users %}{$ user },{% endfor %}",
+        "Users: {% for users as %}{$ user },{% endfor %}",
+        "Users: {% for users user %}{$ user },{% endfor %}",
+        "Users: {% for users into user %}{$ user },{% endfor %}",
+        "{% for servers as user.id %}{% endfor %}",
+        "{% for servers as user[0] %}{% endfor %}",
+        "{% for xs into x %}{% endfor %}"
+    };
+
+    for(const auto& source : sources) {
+        std::string expected;
+        try {
+            Templet(source).parse(DataMap());
+        }
+        catch(const std::exception& ex) {
+            expected = ex.what();
+        }
+        EXPECT_NE(expected, "") << source;
+
+        std::ostringstream os;
+        try {
+            generate_cpp({{"render", source}}, os);
+            ADD_FAILURE() << source;
+        }
+        catch(const std::exception& ex) {
+            EXPECT_EQ(ex.what(), expected) << source;
+        }
+    }
+}
+
+namespace {
+
+template <std::size_t N>
+constexpr literal::Error literal_error(const char (&text)[N]) {
+    return literal::error(text, N - 1);
+}
+
+static_assert(literal_error("hello {$ first_name } {\\$x} {*x} {") == literal::Error::None, "");
+static_assert(literal_error("{% for users as user %}{% endfor %}") == literal::Error::None, "");
+static_assert(literal_error("{% infloop %}") == literal::Error::UnknownTag, "");
+static_assert(literal_error("{% if x }") == literal::Error::NotEnclosed, "");
+static_assert(literal_error("{% if%}") == literal::Error::IfPrefix, "");
+static_assert(literal_error("{% elif%}") == literal::Error::ElifPrefix, "");
+static_assert(literal_error("{$ a b }") == literal::Error::VariableName, "");
+static_assert(literal_error("{% if foo&bar %}") == literal::Error::IfName, "");
+static_assert(literal_error("{% elif foo&bar %}") == literal::Error::IfName, "");
+static_assert(literal_error("{% for users %}") == literal::Error::ForSyntax, "");
+static_assert(literal_error("{% for users  as user %}") == literal::Error::ForSyntax, "");
+static_assert(literal_error("{% for users in user %}") == literal::Error::ForSyntax, "");
+static_assert(literal_error("{% for users as user x %}") == literal::Error::ForSyntax, "");
+static_assert(literal_error("{% for a&b as user %}") == literal::Error::ForName, "");
+static_assert(literal_error("{% for users as u.ser %}") == literal::Error::ForAlias, "");
+
+} // unnamed namespace
+
+TEST(LiteralTemplateTest, SameOutputAsInterpreter) {
+    std::vector<std::pair<std::string, Templet>> literals;
+    literals.emplace_back("", TEMPLET_LITERAL(""));
+    literals.emplace_back("hello, {$first_name} {$last_name}",
+                          TEMPLET_LITERAL("hello, {$first_name} {$last_name}"));
+    literals.emplace_back("hello {world} {\\world} {\\$world} {*world} \"quoted\"?? \t{$ first_name } {",
+                          TEMPLET_LITERAL("hello {world} {\\world} {\\$world} {*world} \"quoted\"?? \t{$ first_name } {"));
+    literals.emplace_back("{% if debug %}Debug mode{% elif test %}Test mode{% elif gravity %}Gravity mode{% else %}Release mode{% endif %}",
+                          TEMPLET_LITERAL("{% if debug %}Debug mode{% elif test %}Test mode{% elif gravity %}Gravity mode{% else %}Release mode{% endif %}"));
+    literals.emplace_back("{% if debug %}Debug mode{% elif test %}Test mode{% else %}Release mode{% if gravity %}Gravity{% endif %}{% endif %}",
+                          TEMPLET_LITERAL("{% if debug %}Debug mode{% elif test %}Test mode{% else %}Release mode{% if gravity %}Gravity{% endif %}{% endif %}"));
+    literals.emplace_back("{%if config.server.hostname%}{$config.server.hostname}{% endif %}/{%  if   config.server.ip  %}{$ config.server.ip }{%endif%}",
+                          TEMPLET_LITERAL("{%if config.server.hostname%}{$config.server.hostname}{% endif %}/{%  if   config.server.ip  %}{$ config.server.ip }{%endif%}"));
+    literals.emplace_back("{% for users as user %}{$ user },{% endfor %}\n"
+                          "{% for servers as s %}{$ s.name } {$ s.load }:{% for s.tags as tag %}{$ tag }{% endfor %};{% endfor %}",
+                          TEMPLET_LITERAL("{% for users as user %}{$ user },{% endfor %}\n"
+                                          "{% for servers as s %}{$ s.name } {$ s.load }:{% for s.tags as tag %}{$ tag }{% endfor %};{% endfor %}"));
+    literals.emplace_back("{% for rows as row %}{$ row.name }{$ row.ip }{% endfor %}",
+                          TEMPLET_LITERAL("{% for rows as row %}{$ row.name }{$ row.ip }{% endfor %}"));
+    literals.emplace_back("Hello {% if is_world %}world", TEMPLET_LITERAL("Hello {% if is_world %}world"));
+    literals.emplace_back("{% else %}Debug mode{% endif %}", TEMPLET_LITERAL("{% else %}Debug mode{% endif %}"));
+
+    for(const auto& values : compiledTemplateInputs()) {
+        for(auto& literal : literals) {
+            Templet tpl(literal.first);
+            std::string expected;
+            std::string error;
+            try {
+                expected = tpl.parse(values);
+            }
+            catch(const std::exception& ex) {
+                error = ex.what();
+            }
+
+            try {
+                EXPECT_EQ(literal.second.parse(values), expected) << literal.first;
+                EXPECT_EQ(error, "") << literal.first;
+            }
+            catch(const std::exception& ex) {
+                EXPECT_EQ(ex.what(), error) << literal.first;
+            }
+        }
+    }
+}
+
+TEST(LiteralTemplateTest, Update) {
+    auto tpl = TEMPLET_LITERAL("Hello {$ name }, {% if greet %}welcome{% endif %}!");
+    DataMap values;
+    values["name"] = make_data("John");
+    EXPECT_EQ(tpl.parse(values), "Hello John, !");
+    values["greet"] = make_data("yes");
+    EXPECT_EQ(tpl.update(values, {"greet"}), "Hello John, welcome!");
+}
+
+TEST(TokenizeTest, TextNodesReferToSource) {
+    const auto text = std::make_shared<const std::string>("a {\\b} {% if c %}d{% endif %}{x}");
+    std::string texts;
+    std::function<void(const std::vector<std::shared_ptr<nodes::Node>>&)> collect;
+    collect = [&](const std::vector<std::shared_ptr<nodes::Node>>& nodes) {
+        for(const auto& node : nodes) {
+            if(node->type() == nodes::NodeType::Text) {
+                const auto& textNode = static_cast<const nodes::Text&>(*node);
+                EXPECT_GE(textNode.data(), text->data());
+                EXPECT_LE(textNode.data() + textNode.size(), text->data() + text->size());
+                texts += textNode.text() + "|";
+            }
+            collect(node->children());
+        }
+    };
+    collect(tokenize(text));
+    EXPECT_EQ(texts, "a |{|b}| |d|{x}|");
+
+    Templet tpl(*text);
+    EXPECT_EQ(tpl.parse(DataMap{{"c", make_data("1")}}), "a {b} d{x}");
+    const Templet copy(tpl);
+    EXPECT_EQ(copy.result(), "a {b} d{x}");
+}
+
+TEST(SegmentStreamTest, RenderToSegments) {
+    const std::string header(100, 'h');
+    const std::string description(200, 'd');
+    Templet tpl(header + "{% for rows as row %}<{$ row.name }:{$ row.count }>{$ row.description }{% endfor %}");
+    DataMap values;
+    DataVector rows;
+    for(int i = 0; i < 3; ++i) {
+        DataMap row;
+        row["name"] = make_data("row" + std::to_string(i));
+        row["count"] = make_data(i);
+        row["description"] = make_data(description);
+        rows.push_back(make_data(row));
+    }
+    values["rows"] = make_data(rows);
+
+    SegmentStream out;
+    tpl.render(values, out);
+    std::ostringstream joined;
+    write_segments(joined, out.segments());
+    const auto expected = tpl.parse(values);
+    EXPECT_EQ(joined.str(), expected);
+
+    // The header and the descriptions are referred to, the rest is copied
+    const auto& segments = out.segments();
+    ASSERT_EQ(segments.size(), 7u);
+    EXPECT_EQ(segments[0].size, header.size());
+    EXPECT_EQ(segments[2].size, description.size());
+    EXPECT_EQ(segments[4].size, description.size());
+
+    out.clear();
+    EXPECT_TRUE(out.segments().empty());
+    out << "again";
+    ASSERT_EQ(out.segments().size(), 1u);
+    EXPECT_EQ(std::string(out.segments()[0].data, out.segments()[0].size), "again");
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(SegmentStreamTest, CreatedValuesAreCopied) {
+    const std::string text(100, 'a');
+    DataMap values;
+    values["list"] = make_string_list(std::vector<std::string>{text});
+    values["lazy"] = make_lazy(types::DataType::String, [&text]{
+        return make_data(text);
+    });
+    values["lazies"] = make_lazy(types::DataType::List, [&text]{
+        return make_data(std::vector<std::string>{text, text});
+    });
+
+    // The elements and the computed values are destroyed by the end
+    // of the render, so none of them may be referred to
+    Templet tpl("[{$ list[0] }|{$ lazy }|{% for lazies as item %}{$ item }{% endfor %}]");
+    SegmentStream out;
+    tpl.render(values, out);
+    EXPECT_EQ(out.segments().size(), 1u);
+    EXPECT_FALSE(out.copying());
+    std::ostringstream joined;
+    write_segments(joined, out.segments());
+    EXPECT_EQ(joined.str(), "[" + text + "|" + text + "|" + text + text + "]");
+
+    // The elements of a list that belongs to the caller are referred to
+    values["items"] = make_data(DataVector{make_data(text)});
+    out.clear();
+    tpl.setTemplate("[{% for items as item %}{$ item }{% endfor %}]");
+    tpl.render(values, out);
+    ASSERT_EQ(out.segments().size(), 3u);
+    EXPECT_EQ(out.segments()[1].size, text.size());
+}
+
+TEST(SegmentStreamTest, LoopInvariantValuesAreReferred) {
+    const std::string text(100, 'a');
+    DataMap values;
+    values["text"] = make_data(text);
+    values["users"] = make_data({"John", "Jane"});
+
+    // The value doesn't read the alias, but it isn't cached into a copy
+    Templet tpl("{% for users as user %}{$ text }{$ user }{% endfor %}");
+    SegmentStream out;
+    tpl.render(values, out);
+    std::ostringstream joined;
+    write_segments(joined, out.segments());
+    EXPECT_EQ(joined.str(), text + "John" + text + "Jane");
+    const auto& segments = out.segments();
+    ASSERT_EQ(segments.size(), 4u);
+    EXPECT_EQ(segments[0].size, text.size());
+    EXPECT_EQ(segments[2].data, segments[0].data);
+}
+
+TEST(SegmentStreamTest, WriteToFileDescriptor) {
+    const std::string text(5000, 'x');
+    SegmentStream out(1);
+    for(int i = 0; i < 2000; ++i) {
+        out.reference(text.data() + i, 1);
+        out << i;
+    }
+    std::ostringstream expected;
+    write_segments(expected, out.segments());
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(write_segments(fileno(file), out.segments()), expected.str().size());
+    std::rewind(file);
+    std::string actual(expected.str().size(), '\0');
+    EXPECT_EQ(std::fread(&actual[0], 1, actual.size(), file), actual.size());
+    std::fclose(file);
+    EXPECT_EQ(actual, expected.str());
+}
+
+TEST(SegmentStreamTest, FileData) {
+    std::string content;
+    for(int i = 0; i < 10000; ++i) {
+        content += std::to_string(i) + ",";
+    }
+    {
+        std::ofstream out {"file_data_test.txt", std::ios::binary};
+        out << content;
+    }
+    DataMap values;
+    values["whole"] = make_file_data("file_data_test.txt");
+    values["part"] = make_file_data("file_data_test.txt", 10, 20);
+    values["tail"] = make_file_data("file_data_test.txt", content.size() - 5, 100);
+    values["none"] = make_file_data("file_data_test.txt", content.size());
+    ASSERT_THROW(make_file_data("file_data_test.txt", content.size() + 1), std::runtime_error);
+    ASSERT_THROW(make_file_data("missing.txt"), std::runtime_error);
+
+    Templet tpl("[{$ part }]{$ whole }[{$ tail }]{% if none %}none{% endif %}");
+    const auto expected = "[" + content.substr(10, 20) + "]" + content + "[" + content.substr(content.size() - 5) + "]none";
+    EXPECT_EQ(tpl.parse(values), expected);
+    EXPECT_EQ(values["part"]->getValue(), content.substr(10, 20));
+
+    SegmentStream out;
+    tpl.render(values, out);
+    std::ostringstream joined;
+    write_segments(joined, out.segments());
+    EXPECT_EQ(joined.str(), expected);
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    EXPECT_EQ(write_segments(fileno(file), out.segments()), expected.size());
+    std::rewind(file);
+    std::string actual(expected.size(), '\0');
+    EXPECT_EQ(std::fread(&actual[0], 1, actual.size(), file), actual.size());
+    std::fclose(file);
+    EXPECT_EQ(actual, expected);
+
+    values.clear();
+    std::remove("file_data_test.txt");
+}
+
+TEST(SegmentStreamTest, FileDataSharedBetweenThreads) {
+    const std::string content(1000, 'f');
+    {
+        std::ofstream out {"file_threads_test.txt", std::ios::binary};
+        out << content;
+    }
+    DataMap values;
+    values["file"] = make_file_data("file_threads_test.txt");
+
+    // The first renders map the file at the same time
+    std::vector<std::string> results(4);
+    std::vector<std::thread> threads;
+    for(auto& result : results) {
+        threads.emplace_back([&values, &result]{
+            Templet local("<{$ file }>");
+            result = local.parse(values) + values.at("file")->getValue();
+        });
+    }
+    for(auto& thread : threads) {
+        thread.join();
+    }
+    for(const auto& result : results) {
+        EXPECT_EQ(result, "<" + content + ">" + content);
+    }
+
+    values.clear();
+    std::remove("file_threads_test.txt");
+}
+#endif
+
+TEST(ChunkRendererTest, SameOutputAsInterpreter) {
+    for(const auto& values : compiledTemplateInputs()) {
+        for(const auto& compiled : compiledTemplates) {
+            for(std::size_t chunkSize : {1, 7, 16384}) {
+                Templet tpl(helpers::FileReader::fromFile("templates/" + compiled.first + ".tpl"));
+                std::string expected;
+                std::string error;
+                try {
+                    expected = tpl.parse(values);
+                }
+                catch(const std::exception& ex) {
+                    error = ex.what();
+                }
+
+                std::string output;
+                try {
+                    auto chunks = tpl.chunks(values, chunkSize);
+                    std::string chunk;
+                    while(chunks.next(chunk)) {
+                        EXPECT_FALSE(chunk.empty());
+                        output += chunk;
+                    }
+                    EXPECT_TRUE(chunks.done());
+                    EXPECT_EQ(output, expected) << compiled.first;
+                    EXPECT_EQ(error, "") << compiled.first;
+                }
+                catch(const std::exception& ex) {
+                    EXPECT_EQ(ex.what(), error) << compiled.first;
+                }
+            }
+        }
+    }
+}
+
+TEST(ChunkRendererTest, ChunkSize) {
+    DataMap values;
+    values["users"] = make_data({"John", "Jane", "Jack"});
+    values["long"] = make_data(std::string(100, 'x'));
+    Templet tpl("{% for users as user %}<li>{$ user }</li>{% endfor %}{$ long }.");
+    auto chunks = tpl.chunks(values, 10);
+    // The renderer keeps the tree alive
+    tpl.setTemplate("");
+    std::vector<std::string> parts;
+    std::string chunk;
+    while(chunks.next(chunk)) {
+        parts.push_back(chunk);
+    }
+    const std::vector<std::string> expected {"<li>John</li>", "<li>Jane</li>", "<li>Jack</li>",
+                                             std::string(100, 'x'), "."};
+    EXPECT_EQ(parts, expected);
+    EXPECT_FALSE(chunks.next(chunk));
+    EXPECT_TRUE(chunk.empty());
+}
+
+TEST(RenderAsyncTest, SuspendOnPendingValue) {
+    std::promise<DataPtr> name;
+    std::promise<DataPtr> users;
+    DataMap slow;
+    slow["name"] = make_future(types::DataType::String, name.get_future().share());
+    slow["users"] = make_future(types::DataType::List, users.get_future().share());
+    DataMap fast;
+    fast["name"] = make_data("fast");
+    fast["users"] = make_data({"John"});
+
+    Templet tpl("Hello {$ name }:{% for users as user %} {$ user }{% endfor %}");
+    std::ostringstream slowOut;
+    std::ostringstream fastOut;
+    LocalExecutor executor;
+    auto slowRender = tpl.renderAsync(slow, slowOut, executor);
+    auto fastRender = tpl.renderAsync(fast, fastOut, executor);
+    std::future_status fastStatus = std::future_status::timeout;
+    std::thread producer([&]{
+        // The fast render completes while the slow one waits
+        fastStatus = fastRender.wait_for(std::chrono::seconds(5));
+        name.set_value(make_data("slow"));
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        users.set_value(make_data({"Jane", "Jack"}));
+    });
+    executor.run();
+    producer.join();
+
+    EXPECT_EQ(fastStatus, std::future_status::ready);
+    fastRender.get();
+    slowRender.get();
+    EXPECT_EQ(fastOut.str(), "Hello fast: John");
+    EXPECT_EQ(slowOut.str(), "Hello slow: Jane Jack");
+}
+
+TEST(RenderAsyncTest, Errors) {
+    std::promise<DataPtr> name;
+    DataMap values;
+    values["name"] = make_future(types::DataType::String, name.get_future().share());
+    name.set_value(make_data(DataVector{}));
+
+    Templet tpl("Hello {$ name }");
+    std::ostringstream os;
+    LocalExecutor executor;
+    auto render = tpl.renderAsync(values, os, executor);
+    executor.run();
+    ASSERT_THROW(render.get(), std::runtime_error);
+
+    Templet missing("{% for users as user %}{% endfor %}");
+    render = missing.renderAsync(values, os, executor);
+    executor.run();
+    ASSERT_THROW(render.get(), templet::exception::MissingTagError);
+}
+
+TEST(CompiledTemplatesTest, SameOutputAsInterpreter) {
+    std::vector<std::pair<std::string, std::string>> templates;
+    for(const auto& compiled : compiledTemplates) {
+        templates.emplace_back(compiled.first, helpers::FileReader::fromFile("templates/" + compiled.first + ".tpl"));
+    }
+    templates.emplace_back("empty", "");
+    std::ostringstream image;
+    save_compiled(templates, image);
+    const auto compiled = CompiledTemplates::fromImage(image.str());
+    EXPECT_EQ(compiled->count(), templates.size());
+
+    for(const auto& values : compiledTemplateInputs()) {
+        for(const auto& source : templates) {
+            ASSERT_TRUE(compiled->contains(source.first, source.second)) << source.first;
+            Templet expectedTpl(source.second);
+            std::string expected;
+            std::string error;
+            try {
+                expected = expectedTpl.parse(values);
+            }
+            catch(const std::exception& ex) {
+                error = ex.what();
+            }
+
+            auto tpl = compiled->get(source.first, source.second);
+            try {
+                EXPECT_EQ(tpl.parse(values), expected) << source.first;
+                EXPECT_EQ(error, "") << source.first;
+            }
+            catch(const std::exception& ex) {
+                EXPECT_EQ(ex.what(), error) << source.first;
+            }
+        }
+    }
+}
+
+TEST(CompiledTemplatesTest, StaleTemplates) {
+    {
+        std::ofstream out {"compiled_test.bin", std::ios::binary};
+        save_compiled({{"hello", "hello {$ name }"}, {"bye", "bye {$ name }"}}, out);
+    }
+    const auto compiled = CompiledTemplates::fromFile("compiled_test.bin");
+    std::remove("compiled_test.bin");
+
+    DataMap values;
+    values["name"] = make_data("John");
+    EXPECT_TRUE(compiled->contains("bye", "bye {$ name }"));
+    EXPECT_FALSE(compiled->contains("bye", "bye, {$ name }"));
+    EXPECT_FALSE(compiled->contains("hi", "hello {$ name }"));
+    EXPECT_EQ(compiled->get("hello", "hello {$ name }").parse(values), "hello John");
+    EXPECT_EQ(compiled->get("hello", "hi {$ name }").parse(values), "hi John");
+    EXPECT_EQ(compiled->get("hi", "hi {$ name }!").parse(values), "hi John!");
+}
+
+TEST(CompiledTemplatesTest, Errors) {
+    ASSERT_THROW(CompiledTemplates::fromImage("not a compiled image"), std::runtime_error);
+    ASSERT_THROW(CompiledTemplates::fromFile("missing.bin"), std::runtime_error);
+
+    std::ostringstream os;
+    ASSERT_THROW(save_compiled({{"a", "x"}, {"a", "y"}}, os), std::runtime_error);
+    ASSERT_THROW(save_compiled({{"a", "{% infloop %}"}}, os), templet::exception::InvalidTagError);
+
+    std::ostringstream image;
+    save_compiled({{"a", "{% if x %}{$ y }{% endif %}"}}, image);
+    ASSERT_THROW(CompiledTemplates::fromImage(image.str().substr(0, image.str().size() - 1)), std::runtime_error);
+    auto corrupt = image.str();
+    corrupt.resize(corrupt.size() - 4);
+    corrupt[20] = static_cast<char>(corrupt.size());
+    const auto compiled = CompiledTemplates::fromImage(corrupt);
+    ASSERT_THROW(compiled->get("a", "{% if x %}{$ y }{% endif %}"), std::runtime_error);
+
+    // Blocks may be nested 512 deep
+    std::string deep;
+    for(int i = 0; i < 512; ++i) {
+        deep = "{% if x %}" + deep + "{% endif %}";
+    }
+    ASSERT_THROW(save_compiled({{"a", "{% if x %}" + deep + "{% endif %}"}}, os), std::runtime_error);
+    image.str("");
+    save_compiled({{"a", deep}}, image);
+    EXPECT_EQ(CompiledTemplates::fromImage(image.str())->get("a", deep).parse({{"x", make_data("1")}}), "");
+
+    // An image with one more level must not be read
+    auto deeper = image.str();
+    // Count 1, If, name "x" padded to 4 bytes
+    const auto level = deeper.substr(deeper.size() - 20, 16);
+    deeper.insert(deeper.size() - 4, level);
+    const auto size = static_cast<std::uint32_t>(deeper.size());
+    std::memcpy(&deeper[20], &size, sizeof(size));
+    ASSERT_THROW(CompiledTemplates::fromImage(deeper)->get("a", deep), std::runtime_error);
+}
+
+TEST(BatchWriterTest, WriteFiles) {
+    Templet tpl("<p>{$ n }</p>");
+    {
+        helpers::BatchWriter writer(4, 8);
+        for(int i = 0; i < 100; ++i) {
+            DataMap values;
+            values["n"] = make_data(i);
+            writer.write("batch_test_" + std::to_string(i) + ".txt", tpl.parse(values));
+        }
+        writer.finish();
+    }
+    for(int i = 0; i < 100; ++i) {
+        const auto path = "batch_test_" + std::to_string(i) + ".txt";
+        EXPECT_EQ(helpers::FileReader::fromFile(path), "<p>" + std::to_string(i) + "</p>");
+        std::remove(path.c_str());
+    }
+
+    tpl.save<helpers::BatchFileWriter>("batch_test_save.txt");
+    helpers::BatchWriter::shared().finish();
+    EXPECT_EQ(helpers::FileReader::fromFile("batch_test_save.txt"), "<p>99</p>");
+    std::remove("batch_test_save.txt");
+}
+
+TEST(BatchWriterTest, Errors) {
+    helpers::BatchWriter writer(2);
+    writer.write("missing_dir/batch_test.txt", "x");
+    writer.write("batch_test_ok.txt", "ok");
+    ASSERT_THROW(writer.finish(), std::runtime_error);
+    EXPECT_EQ(helpers::FileReader::fromFile("batch_test_ok.txt"), "ok");
+    // The error is reported once
+    writer.write("batch_test_ok.txt", "again");
+    writer.finish();
+    EXPECT_EQ(helpers::FileReader::fromFile("batch_test_ok.txt"), "again");
+    std::remove("batch_test_ok.txt");
+}
+
+TEST(BatchWriterTest, ErrorWithoutFinish) {
+    testing::internal::CaptureStderr();
+    {
+        helpers::BatchWriter writer(1);
+        writer.write("missing_dir/batch_test.txt", "x");
+    }
+    EXPECT_EQ(testing::internal::GetCapturedStderr(),
+              "BatchWriter: File can't be opened: missing_dir/batch_test.txt\n");
+
+    // Errors that finish() reported aren't printed again
+    testing::internal::CaptureStderr();
+    {
+        helpers::BatchWriter writer(1);
+        writer.write("missing_dir/batch_test.txt", "x");
+        ASSERT_THROW(writer.finish(), std::runtime_error);
+    }
+    EXPECT_EQ(testing::internal::GetCapturedStderr(), "");
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,50 @@
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "codegen.hpp"
+#include "templet.hpp"
+
+//
+// templetc generates C++ render functions from template files
+//
+// Usage: templetc OUTPUT NAME=FILE...
+//
+// Every FILE is compiled into a function called NAME in OUTPUT.
+//
+
+int main(int argc, char** argv) {
+    if(argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " OUTPUT NAME=FILE...\n";
+        return 2;
+    }
+
+    try {
+        std::vector<std::pair<std::string, std::string>> templates;
+        for(int i = 2; i < argc; ++i) {
+            const std::string arg = argv[i];
+            const auto pos = arg.find('=');
+            if(pos == std::string::npos) {
+                std::cerr << "Expected NAME=FILE: " << arg << "\n";
+                return 2;
+            }
+            templates.emplace_back(arg.substr(0, pos),
+                                   templet::helpers::FileReader::fromFile(arg.substr(pos + 1)));
+        }
+
+        std::ofstream out {argv[1], std::ios::binary};
+        if(!out) {
+            std::cerr << "File can't be opened: " << argv[1] << "\n";
+            return 1;
+        }
+        templet::generate_cpp(templates, out);
+    }
+    catch(const std::exception& ex) {
+        std::cerr << ex.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -25,12 +25,223 @@ THE SOFTWARE.
 */
 
 #include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
 #include <stdexcept>
+#include "ptrutil.hpp"
+#include "segments.hpp"
 #include "types.hpp"
 
 using namespace templet;
 using namespace templet::types;
 
+namespace {
+
+/**
+ * @brief The VectorCursor class reads the elements of a DataVector
+ */
+class VectorCursor : public DataCursor {
+private:
+    const DataVector& _data;
+    DataVector::const_iterator _pos;
+
+public:
+    VectorCursor(const DataVector& data) : _data(data), _pos(data.cbegin()) {}
+
+    const Data* next() override {
+        if(_pos == _data.cend()) {
+            return nullptr;
+        }
+        return (_pos++)->get();
+    }
+};
+
+/**
+ * @brief The StringRef class refers to a string stored in a compact type
+ */
+class StringRef : public Data {
+private:
+    const std::string* _value;
+
+public:
+    StringRef(const std::string* value) : _value(value) {}
+
+    void reset(const std::string* value) {
+        _value = value;
+    }
+
+    bool empty() const override {
+        return _value->empty();
+    }
+
+    std::string getValue() const override {
+        return *_value;
+    }
+
+    DataType type() const override {
+        return DataType::String;
+    }
+};
+
+/**
+ * @brief The StringListCursor class reads the strings of a DataStringList
+ *
+ * The same StringRef is returned for every element
+ */
+class StringListCursor : public DataCursor {
+private:
+    const std::vector<std::string>& _data;
+    std::size_t _pos;
+    StringRef _item;
+
+public:
+    StringListCursor(const std::vector<std::string>& data) : _data(data), _pos(0), _item(nullptr) {}
+
+    const Data* next() override {
+        if(_pos == _data.size()) {
+            return nullptr;
+        }
+        _item.reset(&_data[_pos++]);
+        return &_item;
+    }
+};
+
+/**
+ * @brief The TableRow class is a map of a DataTable row
+ *
+ * The values are StringRefs that are pointed to another row on \link reset \endlink
+ */
+class TableRow : public Data {
+private:
+    const DataTable& _table;
+    std::vector<std::shared_ptr<StringRef>> _cells;
+    mutable std::once_flag _mapOnce;
+    mutable DataMap _map;
+
+public:
+    TableRow(const DataTable& table, std::size_t row) : _table(table), _cells(), _mapOnce(), _map() {
+        const auto columns = _table.columns().size();
+        _cells.reserve(columns);
+        for(std::size_t column = 0; column < columns; ++column) {
+            _cells.push_back(std::make_shared<StringRef>(&_table.cell(row, column)));
+        }
+    }
+
+    void reset(std::size_t row) {
+        for(std::size_t column = 0; column < _cells.size(); ++column) {
+            _cells[column]->reset(&_table.cell(row, column));
+        }
+    }
+
+    bool empty() const override {
+        return _cells.empty();
+    }
+
+    const DataMap& getMap() const override {
+        // The map holds the cells, so it stays valid when they're reset
+        std::call_once(_mapOnce, [this]{
+            for(std::size_t column = 0; column < _cells.size(); ++column) {
+                _map.emplace(_table.columns()[column], _cells[column]);
+            }
+        });
+        return _map;
+    }
+
+    const Data* getItem(const std::string& key, DataPtr& /*holder*/) const override {
+        const auto& columns = _table.columns();
+        const auto it = std::find(columns.cbegin(), columns.cend(), key);
+        if(it == columns.cend()) {
+            return nullptr;
+        }
+        return _cells[static_cast<std::size_t>(it - columns.cbegin())].get();
+    }
+
+    DataType type() const override {
+        return DataType::Mapper;
+    }
+};
+
+/**
+ * @brief The TableCursor class reads the rows of a DataTable
+ *
+ * The same TableRow is returned for every row
+ */
+class TableCursor : public DataCursor {
+private:
+    const DataTable& _table;
+    std::size_t _pos;
+    std::unique_ptr<TableRow> _item;
+
+public:
+    TableCursor(const DataTable& table) : _table(table), _pos(0), _item() {}
+
+    const Data* next() override {
+        if(_pos == _table.rows()) {
+            return nullptr;
+        }
+        if(!_item) {
+            _item = mylib::make_unique<TableRow>(_table, _pos);
+        }
+        else {
+            _item->reset(_pos);
+        }
+        ++_pos;
+        return _item.get();
+    }
+};
+
+/**
+ * @brief Large enough buffer for any formatted number
+ */
+const std::size_t NumberBufferSize = 32;
+
+/**
+ * @brief Format an integer into a buffer
+ * @param value Integer to format
+ * @param buf Buffer of at least NumberBufferSize characters
+ * @return Number of characters written
+ */
+std::size_t format_integer(long long value, char* buf) {
+    // Format backwards from the end of a local buffer
+    char digits[NumberBufferSize];
+    char* pos = digits + NumberBufferSize;
+    // Negate as unsigned to handle the smallest long long
+    unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                             : static_cast<unsigned long long>(value);
+    do {
+        *--pos = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while(magnitude != 0);
+    if(value < 0) {
+        *--pos = '-';
+    }
+
+    const auto size = static_cast<std::size_t>(digits + NumberBufferSize - pos);
+    std::copy(pos, digits + NumberBufferSize, buf);
+    return size;
+}
+
+/**
+ * @brief Format a floating point number into a buffer
+ *
+ * Uses 15 significant digits if the result reads back as the same
+ * number, otherwise 17 digits which always do
+ *
+ * @param value Number to format
+ * @param buf Buffer of at least NumberBufferSize characters
+ * @return Number of characters written
+ */
+std::size_t format_float(double value, char* buf) {
+    int size = std::snprintf(buf, NumberBufferSize, "%.15g", value);
+    if(std::strtod(buf, nullptr) != value) {
+        size = std::snprintf(buf, NumberBufferSize, "%.17g", value);
+    }
+    return static_cast<std::size_t>(size);
+}
+
+} // unnamed namespace
+
 std::string Data::getValue() const {
     throw std::runtime_error("Data item is not of type value");
 }
@@ -43,6 +254,43 @@ const DataMap& Data::getMap() const {
     throw std::runtime_error("Data item is not of type map");
 }
 
+const Data* Data::getItem(std::size_t index, DataPtr& /*holder*/) const {
+    const auto& list = getList();
+    if(index >= list.size()) {
+        return nullptr;
+    }
+    return list[index].get();
+}
+
+const Data* Data::getItem(const std::string& key, DataPtr& /*holder*/) const {
+    const auto& map = getMap();
+    const auto it = map.find(key);
+    if(it == map.cend()) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+std::unique_ptr<DataCursor> Data::getCursor() const {
+    throw std::runtime_error("Data item is not of type list");
+}
+
+void Data::write(std::ostream& os) const {
+    os << getValue();
+}
+
+bool Data::ready() const {
+    return true;
+}
+
+void Data::wait() const {
+
+}
+
+DataPtr Data::compute() const {
+    return nullptr;
+}
+
 DataValue::DataValue(std::string value)
     : _value(std::move(value)) {
 
@@ -56,10 +304,68 @@ std::string DataValue::getValue() const {
     return _value;
 }
 
+void DataValue::write(std::ostream& os) const {
+    write_stable(os, _value.data(), _value.size());
+}
+
 DataType DataValue::type() const {
     return DataType::String;
 }
 
+DataInteger::DataInteger(long long value)
+    : _value(value) {
+
+}
+
+long long DataInteger::value() const {
+    return _value;
+}
+
+bool DataInteger::empty() const {
+    return false;
+}
+
+std::string DataInteger::getValue() const {
+    char buf[NumberBufferSize];
+    return std::string(buf, format_integer(_value, buf));
+}
+
+void DataInteger::write(std::ostream& os) const {
+    char buf[NumberBufferSize];
+    os.write(buf, static_cast<std::streamsize>(format_integer(_value, buf)));
+}
+
+DataType DataInteger::type() const {
+    return DataType::Integer;
+}
+
+DataFloat::DataFloat(double value)
+    : _value(value) {
+
+}
+
+double DataFloat::value() const {
+    return _value;
+}
+
+bool DataFloat::empty() const {
+    return false;
+}
+
+std::string DataFloat::getValue() const {
+    char buf[NumberBufferSize];
+    return std::string(buf, format_float(_value, buf));
+}
+
+void DataFloat::write(std::ostream& os) const {
+    char buf[NumberBufferSize];
+    os.write(buf, static_cast<std::streamsize>(format_float(_value, buf)));
+}
+
+DataType DataFloat::type() const {
+    return DataType::Float;
+}
+
 DataList::DataList(DataVector data)
     : _data(std::move(data)) {
 
@@ -67,6 +373,7 @@ DataList::DataList(DataVector data)
 
 DataList::DataList(std::initializer_list<std::string> items)
     : _data() {
+    _data.reserve(items.size());
     for(auto& item : items) {
         _data.push_back(make_data(std::move(item)));
     }
@@ -80,11 +387,107 @@ const DataVector& DataList::getList() const {
     return _data;
 }
 
+std::unique_ptr<DataCursor> DataList::getCursor() const {
+    return mylib::make_unique<VectorCursor>(_data);
+}
+
 DataType DataList::type() const {
     return DataType::List;
 }
 
 
+DataStringList::DataStringList(std::vector<std::string> data)
+    : _data(std::move(data)), _listOnce(), _list() {
+
+}
+
+const std::vector<std::string>& DataStringList::strings() const {
+    return _data;
+}
+
+bool DataStringList::empty() const {
+    return _data.empty();
+}
+
+const DataVector& DataStringList::getList() const {
+    std::call_once(_listOnce, [this]{
+        _list.reserve(_data.size());
+        for(auto& item : _data) {
+            _list.push_back(make_data(item));
+        }
+    });
+    return _list;
+}
+
+const Data* DataStringList::getItem(std::size_t index, DataPtr& holder) const {
+    if(index >= _data.size()) {
+        return nullptr;
+    }
+    holder = make_data(_data[index]);
+    return holder.get();
+}
+
+std::unique_ptr<DataCursor> DataStringList::getCursor() const {
+    return mylib::make_unique<StringListCursor>(_data);
+}
+
+DataType DataStringList::type() const {
+    return DataType::List;
+}
+
+DataTable::DataTable(std::vector<std::string> columns, std::vector<std::vector<std::string>> rows)
+    : _columns(std::move(columns)), _cells(), _rows(rows.size()), _listOnce(), _list() {
+    _cells.reserve(_columns.size() * _rows);
+    for(auto& row : rows) {
+        if(row.size() != _columns.size()) {
+            throw std::runtime_error("Table row must have a value for every column");
+        }
+        std::move(row.begin(), row.end(), std::back_inserter(_cells));
+    }
+}
+
+const std::vector<std::string>& DataTable::columns() const {
+    return _columns;
+}
+
+std::size_t DataTable::rows() const {
+    return _rows;
+}
+
+const std::string& DataTable::cell(std::size_t row, std::size_t column) const {
+    return _cells[row * _columns.size() + column];
+}
+
+bool DataTable::empty() const {
+    return _rows == 0;
+}
+
+const DataVector& DataTable::getList() const {
+    std::call_once(_listOnce, [this]{
+        _list.reserve(_rows);
+        for(std::size_t row = 0; row < _rows; ++row) {
+            _list.push_back(std::make_shared<TableRow>(*this, row));
+        }
+    });
+    return _list;
+}
+
+const Data* DataTable::getItem(std::size_t index, DataPtr& holder) const {
+    if(index >= _rows) {
+        return nullptr;
+    }
+    holder = std::make_shared<TableRow>(*this, index);
+    return holder.get();
+}
+
+std::unique_ptr<DataCursor> DataTable::getCursor() const {
+    return mylib::make_unique<TableCursor>(*this);
+}
+
+DataType DataTable::type() const {
+    return DataType::List;
+}
+
 DataMapper::DataMapper(DataMap data) : _data(std::move(data)) {
 
 }
@@ -100,3 +503,91 @@ const DataMap& DataMapper::getMap() const {
 DataType DataMapper::type() const {
     return DataType::Mapper;
 }
+
+
+DataProvider::DataProvider(DataType type, std::function<DataPtr()> provider)
+    : _type(type), _provider(std::move(provider)), _mutex(), _data() {
+
+}
+
+const Data& DataProvider::get() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if(!_data) {
+        _data = compute();
+    }
+    return *_data;
+}
+
+void DataProvider::reset() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _data.reset();
+}
+
+DataPtr DataProvider::compute() const {
+    auto data = _provider();
+    if(!data || data->type() != _type) {
+        throw std::runtime_error("Data provider returned a wrong type");
+    }
+    return data;
+}
+
+bool DataProvider::empty() const {
+    return get().empty();
+}
+
+std::string DataProvider::getValue() const {
+    return get().getValue();
+}
+
+const DataVector& DataProvider::getList() const {
+    return get().getList();
+}
+
+const DataMap& DataProvider::getMap() const {
+    return get().getMap();
+}
+
+const Data* DataProvider::getItem(std::size_t index, DataPtr& holder) const {
+    return get().getItem(index, holder);
+}
+
+const Data* DataProvider::getItem(const std::string& key, DataPtr& holder) const {
+    return get().getItem(key, holder);
+}
+
+std::unique_ptr<DataCursor> DataProvider::getCursor() const {
+    return get().getCursor();
+}
+
+void DataProvider::write(std::ostream& os) const {
+    get().write(os);
+}
+
+bool DataProvider::ready() const {
+    return get().ready();
+}
+
+void DataProvider::wait() const {
+    get().wait();
+}
+
+DataType DataProvider::type() const {
+    return _type;
+}
+
+DataStream::DataStream(std::function<std::unique_ptr<DataCursor>()> factory)
+    : _factory(std::move(factory)) {
+
+}
+
+bool DataStream::empty() const {
+    return false;
+}
+
+std::unique_ptr<DataCursor> DataStream::getCursor() const {
+    return _factory();
+}
+
+DataType DataStream::type() const {
+    return DataType::Stream;
+}
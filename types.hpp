@@ -27,9 +27,14 @@ THE SOFTWARE.
 #ifndef TYPES_HPP
 #define TYPES_HPP
 
+#include <functional>
+#include <cstddef>
 #include <initializer_list>
+#include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <ostream>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -49,8 +54,30 @@ using DataMap = std::map<std::string, DataPtr>;
  */
 enum class DataType {
     String,
+    Integer,
+    Float,
     List,
-    Mapper
+    Mapper,
+    Stream
+};
+
+/**
+ * @brief The DataCursor class reads the elements of a list one at a time
+ */
+class DataCursor {
+public:
+    virtual ~DataCursor() = default;
+
+    /**
+     * @brief Read the next element
+     *
+     * The cursor keeps the element alive until the next call or until
+     * the cursor is destroyed. Compact types reuse the same object for
+     * every element.
+     *
+     * @return Next element or null if there are no more elements
+     */
+    virtual const Data* next() = 0;
 };
 
 /**
@@ -67,6 +94,9 @@ public:
 
     /**
      * @brief Get string value from object
+     *
+     * Renders write values with \link write \endlink, which doesn't copy them
+     *
      * @exception std::runtime_error if the derived class doesn't support this type
      * @return Value as a string
      */
@@ -86,6 +116,77 @@ public:
      */
     virtual const DataMap& getMap() const;
 
+    /**
+     * @brief Get a list element
+     *
+     * The element is borrowed from this object. Types that have to create
+     * the element store it in holder, which must be kept alive as long
+     * as the element is used. The default implementation uses \link getList \endlink
+     *
+     * @param index Index of the element
+     * @param holder Owner of the element if it had to be created
+     * @exception std::runtime_error if the derived class doesn't support this type
+     * @return Element or null if index is out of range
+     */
+    virtual const Data* getItem(std::size_t index, DataPtr& holder) const;
+
+    /**
+     * @brief Get a map value
+     *
+     * See the list version for how holder is used.
+     * The default implementation uses \link getMap \endlink
+     *
+     * @param key Key of the value
+     * @param holder Owner of the value if it had to be created
+     * @exception std::runtime_error if the derived class doesn't support this type
+     * @return Value or null if key is not found
+     */
+    virtual const Data* getItem(const std::string& key, DataPtr& holder) const;
+
+    /**
+     * @brief Get a cursor that reads the elements of a list or a stream
+     * @exception std::runtime_error if the derived class doesn't support this type
+     * @return Cursor positioned before the first element
+     */
+    virtual std::unique_ptr<DataCursor> getCursor() const;
+
+    /**
+     * @brief Write the value to an output stream
+     *
+     * The default implementation writes \link getValue \endlink
+     *
+     * @param os Output stream
+     * @exception std::runtime_error if the derived class doesn't support this type
+     */
+    virtual void write(std::ostream& os) const;
+
+    /**
+     * @brief Check whether the value can be read without waiting
+     *
+     * The default implementation returns true
+     *
+     * @return False if the value is still being computed, otherwise true
+     */
+    virtual bool ready() const;
+
+    /**
+     * @brief Wait until the value can be read
+     *
+     * The default implementation returns immediately
+     */
+    virtual void wait() const;
+
+    /**
+     * @brief Compute the value of data that is computed on demand
+     *
+     * Renders call this at most once per render and read the result
+     * instead of this object. The default implementation returns null.
+     *
+     * @exception std::runtime_error if the value can't be computed
+     * @return Computed data, or null if this data isn't computed on demand
+     */
+    virtual DataPtr compute() const;
+
     /**
      * @brief Get the type of the data object
      * @return type as DataType
@@ -108,6 +209,83 @@ public:
     DataValue(std::string value);
     bool empty() const override;
     std::string getValue() const override;
+    void write(std::ostream& os) const override;
+    DataType type() const override;
+};
+
+/**
+ * @brief The DataInteger class wraps an integer
+ *
+ * The integer is formatted only when it's written
+ */
+class DataInteger : public Data {
+private:
+    long long _value;
+
+public:
+    /**
+     * @brief Construct a DataInteger with an integer
+     * @param value Integer value
+     */
+    DataInteger(long long value);
+
+    /**
+     * @brief Get the integer value
+     * @return Integer value
+     */
+    long long value() const;
+
+    bool empty() const override;
+
+    /**
+     * @brief Format the integer. Nothing is kept, so threads can share the value
+     */
+    std::string getValue() const override;
+    void write(std::ostream& os) const override;
+    DataType type() const override;
+};
+
+/**
+ * @brief Check whether an integral value fits in a DataInteger
+ * @param value Value to check
+ * @return False for unsigned values above the largest long long, otherwise true
+ */
+template <typename T>
+bool fits_integer(T value) {
+    return !std::is_unsigned<T>::value ||
+            static_cast<unsigned long long>(value) <= static_cast<unsigned long long>(std::numeric_limits<long long>::max());
+}
+
+/**
+ * @brief The DataFloat class wraps a floating point number
+ *
+ * The number is formatted only when it's written, using the
+ * shortest representation that reads back as the same number
+ */
+class DataFloat : public Data {
+private:
+    double _value;
+
+public:
+    /**
+     * @brief Construct a DataFloat with a floating point number
+     * @param value Floating point value
+     */
+    DataFloat(double value);
+
+    /**
+     * @brief Get the floating point value
+     * @return Floating point value
+     */
+    double value() const;
+
+    bool empty() const override;
+
+    /**
+     * @brief Format the number. Nothing is kept, so threads can share the value
+     */
+    std::string getValue() const override;
+    void write(std::ostream& os) const override;
     DataType type() const override;
 };
 
@@ -133,6 +311,102 @@ public:
 
     bool empty() const override;
     const DataVector& getList() const override;
+    std::unique_ptr<DataCursor> getCursor() const override;
+    DataType type() const override;
+};
+
+/**
+ * @brief The DataStringList class stores a list of strings contiguously
+ *
+ * Unlike DataList, the elements are not wrapped in their own DataPtr.
+ * For blocks and [n] access read the strings directly. Created with
+ * \link templet::make_string_list make_string_list \endlink.
+ */
+class DataStringList : public Data {
+private:
+    std::vector<std::string> _data;
+    mutable std::once_flag _listOnce;
+    mutable DataVector _list;
+
+public:
+    /**
+     * @brief Construct a DataStringList with a vector of strings
+     * @param data Vector of strings
+     */
+    DataStringList(std::vector<std::string> data);
+
+    /**
+     * @brief Get the strings
+     * @return Vector of strings
+     */
+    const std::vector<std::string>& strings() const;
+
+    bool empty() const override;
+
+    /**
+     * @brief Wraps every string in a DataPtr on the first call, guarded by std::call_once.
+     * The parser doesn't use it
+     */
+    const DataVector& getList() const override;
+    const Data* getItem(std::size_t index, DataPtr& holder) const override;
+    std::unique_ptr<DataCursor> getCursor() const override;
+    DataType type() const override;
+};
+
+/**
+ * @brief The DataTable class stores a list of maps as rows of strings
+ *
+ * The column names are stored once for the whole table and the rows
+ * are stored contiguously. Each element of the list is a map from the
+ * column names to the row's values, so e.g. {$ server.ip } works in
+ * {% for servers as server %}. The rows are valid as long as the table.
+ */
+class DataTable : public Data {
+private:
+    std::vector<std::string> _columns;
+    std::vector<std::string> _cells;
+    std::size_t _rows;
+    mutable std::once_flag _listOnce;
+    mutable DataVector _list;
+
+public:
+    /**
+     * @brief Construct a DataTable with column names and rows
+     * @param columns Column names
+     * @param rows Rows that each have a value for every column
+     * @exception std::runtime_error if a row has a wrong number of values
+     */
+    DataTable(std::vector<std::string> columns, std::vector<std::vector<std::string>> rows);
+
+    /**
+     * @brief Get the column names
+     * @return Column names
+     */
+    const std::vector<std::string>& columns() const;
+
+    /**
+     * @brief Get the number of rows
+     * @return Number of rows
+     */
+    std::size_t rows() const;
+
+    /**
+     * @brief Get a value in the table
+     * @param row Row index
+     * @param column Column index
+     * @return Value
+     */
+    const std::string& cell(std::size_t row, std::size_t column) const;
+
+    bool empty() const override;
+
+    /**
+     * @brief Creates a map for every row on the first call, guarded by std::call_once.
+     * The parser doesn't use it
+     */
+    const DataVector& getList() const override;
+    const Data* getItem(std::size_t index, DataPtr& holder) const override;
+    std::unique_ptr<DataCursor> getCursor() const override;
     DataType type() const override;
 };
 
@@ -157,21 +431,129 @@ public:
     DataType type() const override;
 };
 
+/**
+ * @brief The DataProvider class computes its value on demand
+ *
+ * A render calls the provider callback the first time it reads the
+ * name and reuses the result until the render ends, so every render
+ * sees a fresh value. The result is kept by the render, not by this
+ * object, so renders in different threads can share it. Checking the
+ * type doesn't call the provider, and neither do blocks that aren't
+ * rendered.
+ *
+ * Reading the value directly, e.g. with \link getValue \endlink,
+ * calls the provider once and reuses the result until \link reset \endlink
+ * is called. The first call is guarded by a mutex, but reset must not
+ * be called while the value is read.
+ */
+class DataProvider : public Data {
+private:
+    DataType _type;
+    std::function<DataPtr()> _provider;
+    // Result for reading the value outside of renders
+    mutable std::mutex _mutex;
+    mutable DataPtr _data;
+
+    /**
+     * @brief Call the provider unless it's already been called
+     * @exception std::runtime_error if the provider returns a wrong type
+     * @return Computed data
+     */
+    const Data& get() const;
+
+public:
+    /**
+     * @brief Construct a DataProvider with a type and a callback
+     * @param type Type of the data that the callback returns
+     * @param provider Callback that computes the data
+     */
+    DataProvider(DataType type, std::function<DataPtr()> provider);
+
+    /**
+     * @brief Forget the computed data so that the next access calls the provider again
+     */
+    void reset();
+
+    bool empty() const override;
+    std::string getValue() const override;
+    const DataVector& getList() const override;
+    const DataMap& getMap() const override;
+    const Data* getItem(std::size_t index, DataPtr& holder) const override;
+    const Data* getItem(const std::string& key, DataPtr& holder) const override;
+    std::unique_ptr<DataCursor> getCursor() const override;
+    void write(std::ostream& os) const override;
+    bool ready() const override;
+    void wait() const override;
+
+    /**
+     * @brief Call the provider
+     * @exception std::runtime_error if the provider returns a wrong type
+     * @return Computed data
+     */
+    DataPtr compute() const override;
+
+    DataType type() const override;
+};
+
+/**
+ * @brief The DataStream class reads list elements on demand
+ *
+ * Unlike DataList, the elements are never stored. A for block reads
+ * them one at a time from a cursor, so e.g. rows from a file can be
+ * parsed without loading them all. Streams can't be indexed with [n].
+ */
+class DataStream : public Data {
+private:
+    std::function<std::unique_ptr<DataCursor>()> _factory;
+
+public:
+    /**
+     * @brief Construct a DataStream with a cursor factory
+     * @param factory Callback that returns a new cursor for each traversal
+     */
+    DataStream(std::function<std::unique_ptr<DataCursor>()> factory);
+
+    /**
+     * @brief Streams are never considered empty as that would require reading them
+     * @return false
+     */
+    bool empty() const override;
+    std::unique_ptr<DataCursor> getCursor() const override;
+    DataType type() const override;
+};
+
 } // namespace types
 
 // Expose user data types in general templet namespace
+using types::DataCursor;
 using types::DataMap;
 using types::DataPtr;
 using types::DataVector;
 
 /**
  * @brief Wrap an integral type in a DataPtr
+ *
+ * Unsigned values that don't fit in a long long are wrapped as strings
+ *
  * @param value Value to wrap
  * @return Value wrapped in DataPtr
  */
 template <typename T, typename = typename std::enable_if<std::is_integral<T>::value>::type>
 static inline types::DataPtr make_data(T value) {
-    return std::make_shared<types::DataValue>(std::to_string(value));
+    if(!types::fits_integer(value)) {
+        return std::make_shared<types::DataValue>(std::to_string(value));
+    }
+    return std::make_shared<types::DataInteger>(static_cast<long long>(value));
+}
+
+/**
+ * @brief Wrap a floating point type in a DataPtr
+ * @param value Value to wrap
+ * @return Value wrapped in DataPtr
+ */
+template <typename T>
+static inline typename std::enable_if<std::is_floating_point<T>::value, types::DataPtr>::type make_data(T value) {
+    return std::make_shared<types::DataFloat>(static_cast<double>(value));
 }
 
 /**
@@ -198,7 +580,8 @@ static inline types::DataPtr make_data(types::DataVector value) {
  * @return Value wrapped in DataPtr
  */
 static inline types::DataPtr make_data(std::vector<std::string> value) {
-    DataVector vec;
+    types::DataVector vec;
+    vec.reserve(value.size());
     for(auto& v : value) {
         vec.push_back(make_data(std::move(v)));
     }
@@ -214,6 +597,30 @@ static inline types::DataPtr make_data(std::initializer_list<std::string> value)
     return std::make_shared<types::DataList>(std::move(value));
 }
 
+/**
+ * @brief Wrap a vector of strings in a DataPtr that stores them contiguously
+ *
+ * Unlike make_data, the strings aren't wrapped in a DataPtr each,
+ * see \link types::DataStringList \endlink
+ *
+ * @param value Vector of strings to wrap
+ * @return String list wrapped in DataPtr
+ */
+static inline types::DataPtr make_string_list(std::vector<std::string> value) {
+    return std::make_shared<types::DataStringList>(std::move(value));
+}
+
+/**
+ * @brief Wrap a table of strings in a DataPtr
+ * @param columns Column names
+ * @param rows Rows that each have a value for every column
+ * @exception std::runtime_error if a row has a wrong number of values
+ * @return Table wrapped in DataPtr
+ */
+static inline types::DataPtr make_table(std::vector<std::string> columns, std::vector<std::vector<std::string>> rows) {
+    return std::make_shared<types::DataTable>(std::move(columns), std::move(rows));
+}
+
 /**
  * @brief Wrap a DataMap in a DataPtr
  * @param value DataMap to wrap
@@ -223,6 +630,25 @@ static inline types::DataPtr make_data(types::DataMap value) {
     return std::make_shared<types::DataMapper>(std::move(value));
 }
 
+/**
+ * @brief Wrap a callback in a DataPtr that computes its value on demand
+ * @param type Type of the data that the callback returns
+ * @param provider Callback that computes the data
+ * @return Callback wrapped in DataPtr
+ */
+static inline types::DataPtr make_lazy(types::DataType type, std::function<types::DataPtr()> provider) {
+    return std::make_shared<types::DataProvider>(type, std::move(provider));
+}
+
+/**
+ * @brief Wrap a cursor factory in a DataPtr
+ * @param factory Callback that returns a new cursor for each traversal
+ * @return Stream wrapped in DataPtr
+ */
+static inline types::DataPtr make_stream(std::function<std::unique_ptr<types::DataCursor>()> factory) {
+    return std::make_shared<types::DataStream>(std::move(factory));
+}
+
 } // namespace templet
 
 #endif // TYPES_HPP